@@ -0,0 +1,208 @@
+/// @file jamanak_bench.cpp
+/// @brief Measures the overhead of Jamanak itself and writes the results as JSON.
+///
+/// Usage: jamanak_bench [output.json] [max_threads]
+
+#include "jamanak.hpp"
+#include "jamanak_analysis.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+/// @brief Returns nanoseconds elapsed since @p t0.
+double since(BenchClock::time_point t0) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - t0).count());
+}
+
+/// @brief Returns the median of @p v (reorders it).
+double median(std::vector<double>& v) {
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2), v.end());
+    return v[v.size() / 2];
+}
+
+/// @brief Runs @p fn @p reps times and returns the median time per run in nanoseconds.
+template <typename Fn>
+double time_median(size_t reps, Fn&& fn) {
+    std::vector<double> samples;
+    for (size_t r = 0; r < reps; ++r) {
+        auto t0 = BenchClock::now();
+        fn();
+        samples.push_back(since(t0));
+    }
+    return median(samples);
+}
+
+/// @brief Returns "label N" for label index @p i.
+std::string label(size_t i) { return "label " + std::to_string(i); }
+
+/// @brief Records @p epochs epochs of @p labels jams each.
+void fill(jamanak::Jamanak& j, size_t labels, size_t epochs) {
+    for (size_t e = 0; e < epochs; ++e) {
+        j.begin_epoch();
+        for (size_t l = 0; l < labels; ++l) {
+            j.start(label(l));
+            j.stop();
+        }
+        j.end_epoch();
+    }
+}
+
+/// @brief Appends `"key": [{"<x>": .., "<y>": ..}, ...]` to @p out.
+void json_series(std::string& out, const char* key, const char* x, const char* y,
+                 const std::vector<std::pair<size_t, double>>& series) {
+    out += std::string("  \"") + key + "\": [";
+    for (size_t i = 0; i < series.size(); ++i) {
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "%s{\"%s\": %zu, \"%s\": %.1f}", i ? ", " : "", x, series[i].first, y, series[i].second);
+        out += buf;
+    }
+    out += "]";
+}
+
+} // namespace
+
+int main (int argc, char** argv) {
+
+    const char* path = argc > 1 ? argv[1] : "jamanak_bench.json";
+    const size_t max_threads = std::max<size_t>(1, argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                                            : std::thread::hardware_concurrency());
+
+    // ---- Per-call overhead ----
+    const size_t batch = 10000;
+    jamanak::Jamanak pairs("bench");
+    pairs.start("warmup");
+    pairs.end();
+
+    double pair_ns = time_median(21, [&] {
+        pairs.begin_epoch();
+        for (size_t i = 0; i < batch; ++i) {
+            pairs.start("pair");
+            pairs.end();
+        }
+    }) / static_cast<double>(batch);
+
+    double stop_ns = time_median(21, [&] {
+        pairs.begin_epoch();
+        for (size_t i = 0; i < batch; ++i) {
+            pairs.start("pair");
+            pairs.stop();
+        }
+    }) / static_cast<double>(batch);
+
+    // end_epoch() alone, on an epoch of two jams prepared outside the timed region.
+    jamanak::Jamanak epochs("bench");
+    std::vector<double> end_epoch_samples;
+    for (size_t r = 0; r < 1001; ++r) {
+        epochs.start("a");
+        epochs.stop();
+        epochs.start("b");
+        epochs.stop();
+        auto t0 = BenchClock::now();
+        epochs.end_epoch();
+        end_epoch_samples.push_back(since(t0));
+    }
+    double end_epoch_ns = median(end_epoch_samples);
+
+    double averages_ns = time_median(21, [&] { (void)epochs.epoch_averages(); });
+    double report_ns   = time_median(21, [&] { (void)epochs.to_string_epochs(); });
+
+    std::printf("start/end pair:     %10.1f ns\n", pair_ns);
+    std::printf("start/stop pair:    %10.1f ns\n", stop_ns);
+    std::printf("end_epoch:          %10.1f ns (2 jams, end_epoch only)\n", end_epoch_ns);
+    std::printf("epoch_averages:     %10.1f ns (%zu epochs)\n", averages_ns, epochs.epoch_count());
+    std::printf("to_string_epochs:   %10.1f ns (%zu epochs)\n", report_ns, epochs.epoch_count());
+
+    // ---- Throughput under 1..N threads, one lane per thread ----
+    std::vector<std::pair<size_t, double>> scaling;
+    const size_t per_thread = 200000;
+    std::vector<size_t> thread_counts;
+    for (size_t t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+
+    for (size_t threads : thread_counts) {
+        jamanak::Jamanak parent("bench");
+        std::vector<jamanak::Lane> lanes;
+        for (size_t t = 0; t < threads; ++t) lanes.push_back(parent.fork());
+
+        // Threads are started first and released together; only their work is timed.
+        std::atomic<size_t> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<BenchClock::time_point> done(threads);
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                ++ready;
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                for (size_t i = 0; i < per_thread; ++i) {
+                    lanes[t].start("pair");
+                    lanes[t].stop();
+                }
+                done[t] = BenchClock::now();
+            });
+        }
+        while (ready.load() < threads) std::this_thread::yield();
+        auto t0 = BenchClock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& th : pool) th.join();
+        const double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(*std::max_element(done.begin(), done.end()) - t0).count());
+
+        const double pairs_per_s = static_cast<double>(threads * per_thread) / ns * 1e9;
+        scaling.emplace_back(threads, pairs_per_s);
+        std::printf("%2zu threads:         %10.0f pairs/s\n", threads, pairs_per_s);
+    }
+
+    // ---- Report rendering time versus label count ----
+    std::vector<std::pair<size_t, double>> by_labels;
+    for (size_t labels = 1; labels <= 1024; labels *= 4) {
+        jamanak::Jamanak j("bench");
+        fill(j, labels, 100);
+        by_labels.emplace_back(labels, time_median(5, [&] { (void)j.to_string_epochs(); }));
+        std::printf("report, %4zu labels: %10.1f µs\n", labels, by_labels.back().second / 1e3);
+    }
+
+    // ---- Aggregation time versus epoch count ----
+    std::vector<std::pair<size_t, double>> by_epochs;
+    for (size_t n = 10; n <= 100000; n *= 10) {
+        jamanak::Jamanak j("bench");
+        fill(j, 8, n);
+        by_epochs.emplace_back(n, time_median(5, [&] { (void)j.label_stats(); }));
+        std::printf("stats, %6zu epochs: %10.1f µs\n", n, by_epochs.back().second / 1e3);
+    }
+
+    // ---- JSON ----
+    std::string out = "{\n";
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "  \"pair_ns\": %.2f,\n  \"stop_pair_ns\": %.2f,\n  \"end_epoch_ns\": %.1f,\n"
+                  "  \"epoch_averages_ns\": %.1f,\n  \"to_string_epochs_ns\": %.1f,\n",
+                  pair_ns, stop_ns, end_epoch_ns, averages_ns, report_ns);
+    out += buf;
+    json_series(out, "thread_scaling", "threads", "pairs_per_s", scaling);
+    out += ",\n";
+    json_series(out, "report_vs_labels", "labels", "ns", by_labels);
+    out += ",\n";
+    json_series(out, "stats_vs_epochs", "epochs", "ns", by_epochs);
+    out += "\n}\n";
+
+    FILE* f = std::fopen(path, "w");
+    if (!f) {
+        std::fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    std::fputs(out.c_str(), f);
+    std::fclose(f);
+    std::printf("wrote %s\n", path);
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+# jamanak_instrument(<target>
+#                    [EXCLUDE_FILES <path-fragment>...]
+#                    [EXCLUDE_FUNCTIONS <name-fragment>...])
+#
+# Compiles <target> with -finstrument-functions and links jamanak::instrument, so
+# every function it defines is timed. System headers and the jamanak headers are
+# always excluded; EXCLUDE_FILES and EXCLUDE_FUNCTIONS add substrings to GCC's
+# exclusion lists. Other compilers cannot exclude the jamanak headers and are
+# rejected. Executables are linked with exported symbols so dladdr can name their
+# functions.
+function(jamanak_instrument target)
+  cmake_parse_arguments(JI "" "" "EXCLUDE_FILES;EXCLUDE_FUNCTIONS" ${ARGN})
+
+  if(NOT TARGET jamanak::instrument)
+    message(FATAL_ERROR "jamanak_instrument(${target}): jamanak::instrument is not available (JAMANAK_INSTRUMENT=OFF?)")
+  endif()
+
+  if(NOT CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    message(FATAL_ERROR "jamanak_instrument(${target}): needs GCC; ${CMAKE_CXX_COMPILER_ID} cannot exclude the jamanak headers from instrumentation")
+  endif()
+
+  set(files /usr/include/
+            jamanak.hpp jamanak_instrument.hpp jamanak_runner.hpp jamanak_session.hpp
+            ${JI_EXCLUDE_FILES})
+  list(JOIN files "," files)
+  target_compile_options(${target} PRIVATE -finstrument-functions
+                         "-finstrument-functions-exclude-file-list=${files}")
+
+  if(JI_EXCLUDE_FUNCTIONS)
+    list(JOIN JI_EXCLUDE_FUNCTIONS "," functions)
+    target_compile_options(${target} PRIVATE "-finstrument-functions-exclude-function-list=${functions}")
+  endif()
+
+  target_link_libraries(${target} PRIVATE jamanak::instrument)
+
+  get_target_property(type ${target} TYPE)
+  if(type STREQUAL "EXECUTABLE")
+    set_target_properties(${target} PROPERTIES ENABLE_EXPORTS ON)
+  endif()
+endfunction()
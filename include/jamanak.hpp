@@ -1,14 +1,13 @@
 #pragma once
 
 #include <chrono>
-#include <cstring>
-#include <iomanip>
-#include <stdexcept>
-#include <vector>
-#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
-#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #define ANSI_ESC        "\033["
 #define ANSI_RESET      ANSI_ESC "0m"
@@ -18,50 +17,379 @@
 
 /// @file jamanak.hpp
 /// @brief Lightweight scope-based profiler with epoch averaging and ANSI terminal output.
+///
+/// This header only holds the recording path: jams, lanes and epochs. Statistics and
+/// reports are compiled into the jamanak library (src/jamanak.cpp); their result and
+/// option types live in jamanak_analysis.hpp, and the enum-indexed StageJamanak in
+/// jamanak_stages.hpp.
 
 namespace jamanak {
 
 /// @brief Profiler state: actively measuring or idle.
 enum State { jamming, idle };
 
-/// @brief Time unit (currently unused externally, reserved for future API).
-enum Unit { milli, nano, sec };
+/// @brief Time unit of a report; `automatic` picks ns/µs/ms/s per table.
+enum Unit { milli, nano, sec, micro, automatic };
+
+/// @brief Clock used for all timestamps.
+using Clock = std::chrono::high_resolution_clock;
 
 /// @brief A single named timing measurement.
 struct Jam {
     std::string context;                                   ///< Label for this measurement.
-    std::chrono::_V2::system_clock::time_point t0{};      ///< Start timestamp.
-    std::chrono::_V2::system_clock::time_point t1{};      ///< End timestamp.
-    double duration_ms;                                    ///< Elapsed time in milliseconds.
+    Clock::time_point t0{};                                ///< Start timestamp.
+    Clock::time_point t1{};                                ///< End timestamp.
+    double duration_ms;                                    ///< Elapsed time in milliseconds (derived from duration_ns).
+    size_t thread{0};                                      ///< Lane it was recorded on (0 = owning thread).
+    size_t id{0};                                          ///< Index of the jam within its epoch.
+    std::int64_t duration_ns{0};                           ///< Elapsed time in nanoseconds.
+    std::uint64_t items{0};                                ///< Items processed, if annotated.
+    std::uint64_t bytes{0};                                ///< Bytes processed, if annotated.
+};
+
+/// @brief Compact 16-byte jam record used by the profiler's stores.
+///
+/// Labels are interned; times are nanoseconds since the owning profiler's origin,
+/// which is its construction time until epoch boundaries move it forward.
+/// Fields have fixed limits:
+/// - start: below 2^48 ns (about 78.2 hours after the origin),
+/// - duration: below 2^40 ns (about 18.3 minutes),
+/// - lane: at most 2^16 - 1.
+/// Values past a limit are clamped to it; the profiler counts every clamped jam
+/// (Jamanak::saturated_jams()) and flags them in its reports.
+struct PackedJam {
+    std::uint64_t start_ns : 48;                           ///< Start, ns since the profiler's origin.
+    std::uint64_t thread   : 16;                           ///< Lane index (0 = owning thread).
+    std::uint64_t dur_ns   : 40;                           ///< Duration in nanoseconds.
+    std::uint64_t label    : 24;                           ///< Interned label id.
+
+    static constexpr std::uint64_t max_start  = (1ull << 48) - 1;
+    static constexpr std::uint64_t max_thread = (1ull << 16) - 1;
+    static constexpr std::uint64_t max_dur    = (1ull << 40) - 1;
+    static constexpr std::uint64_t max_label  = (1ull << 24) - 1;
+};
+
+static_assert(sizeof(PackedJam) == 16, "PackedJam must stay 16 bytes");
+
+/// @brief Work annotation of one jam; kept in a sparse side table next to the packed jams.
+struct Work {
+    size_t jam;                                            ///< Id of the jam within its epoch.
+    std::uint64_t items;                                   ///< Items processed.
+    std::uint64_t bytes;                                   ///< Bytes processed.
+};
+
+/// @brief Kind of a cross-thread dependency between two jams.
+enum EdgeKind { spawn, join };
+
+/// @brief Happens-before edge: jam `to` could not start before jam `from` ended.
+struct Edge {
+    size_t from;                                           ///< Id of the preceding jam.
+    size_t to;                                             ///< Id of the dependent jam.
+    EdgeKind kind;                                         ///< Spawn (fork) or join edge.
+};
+
+/// @brief A completed epoch: a slice of the packed jam store and the dependency edges within it.
+struct Epoch {
+    size_t first{0};                                       ///< Index of the epoch's first jam in the store.
+    size_t count{0};                                       ///< Number of jams in the epoch.
+    std::vector<Edge> edges;                               ///< Explicit cross-thread edges.
+    std::int64_t begin_ns{0};                              ///< Wall-clock start, ns since the profiler's origin.
+    std::int64_t end_ns{0};                                ///< Wall-clock end, ns since the profiler's origin.
+    size_t work_first{0};                                  ///< Index of the epoch's first work annotation.
+    size_t work_count{0};                                  ///< Number of annotated jams.
+};
+
+// Defined in jamanak_analysis.hpp.
+struct CriticalLabel;
+struct LabelStats;
+struct BootstrapOptions;
+struct ReportOptions;
+struct JitterContributor;
+struct StabilityOptions;
+struct LabelStability;
+struct SteadyOptions;
+struct Environment;
+
+// Defined in jamanak_stages.hpp.
+struct StageMoments;
+
+class Jamanak;
+class FrameBudget;
+
+template <typename Stage, size_t N>
+class StageJamanak;
+
+/// @brief Recorder for work forked onto another thread.
+///
+/// Obtained from Jamanak::fork(). A lane buffers its jams locally, so it can be
+/// driven from a worker thread without locking; Jamanak::join() merges them back
+/// into the owning profiler once the worker is done.
+class Lane {
+    friend class Jamanak;
+
+private:
+    size_t thread{0};                        ///< Lane index, unique within the epoch.
+    bool has_parent{false};                  ///< Whether a spawning jam exists.
+    size_t parent{0};                        ///< Id of the spawning jam in the owner's epoch.
+    std::uint64_t generation{0};             ///< Owner's epoch generation at fork().
+    std::vector<Jam> jams;                   ///< Jams recorded on this lane.
+    Jam current_jam;                         ///< The currently active Jam, if any.
+    State jam_state{State::idle};            ///< Whether a measurement is in progress.
+
+    Lane(size_t thread, bool has_parent, size_t parent, std::uint64_t generation)
+        : thread(thread), has_parent(has_parent), parent(parent), generation(generation) {  }
+
+public:
+    /// @brief Starts a new measurement on this lane. Throws if already jamming.
+    /// @param context Label for this measurement.
+    void start(const std::string& context) {
+        if (jam_state == State::jamming) throw std::runtime_error("already jamming");
+
+        current_jam = Jam{};
+        current_jam.context = context;
+        current_jam.thread = thread;
+        current_jam.t0 = Clock::now();
+        jam_state = State::jamming;
+    }
+
+    /// @brief Stops the current measurement on this lane and records it, without returning a copy.
+    ///
+    /// The allocation-free counterpart of end() for hot loops.
+    /// @return Index of the jam on this lane.
+    /// @throws std::runtime_error if no measurement is active.
+    size_t stop() {
+        auto t1 = Clock::now();
+        if (jam_state == State::idle) throw std::runtime_error("jamming not started");
+
+        current_jam.t1 = t1;
+        current_jam.duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - current_jam.t0).count();
+        current_jam.duration_ms = static_cast<double>(current_jam.duration_ns) / 1e6;
+        jams.push_back(std::move(current_jam));
+        jam_state = State::idle;
+
+        return jams.size() - 1;
+    }
+
+    /// @brief Stops the current measurement, annotates it with the work it did, and records it.
+    /// @param items Items processed.
+    /// @param bytes Bytes processed.
+    /// @return Index of the jam on this lane.
+    /// @throws std::runtime_error if no measurement is active.
+    size_t stop(std::uint64_t items, std::uint64_t bytes = 0) {
+        const size_t id = stop();
+        jams.back().items = items;
+        jams.back().bytes = bytes;
+        return id;
+    }
+
+    /// @brief Stops the current measurement on this lane and returns it.
+    /// @throws std::runtime_error if no measurement is active.
+    std::shared_ptr<Jam> end() { return std::make_shared<Jam>(jams[stop()]); }
+
+    /// @brief Stops the current measurement and annotates it with the work it did.
+    /// @param items Items processed.
+    /// @param bytes Bytes processed.
+    /// @throws std::runtime_error if no measurement is active.
+    std::shared_ptr<Jam> end(std::uint64_t items, std::uint64_t bytes = 0) {
+        return std::make_shared<Jam>(jams[stop(items, bytes)]);
+    }
+
+    /// @brief Returns true if a measurement is currently in progress.
+    bool is_jamming() const { return jam_state == State::jamming; }
 };
 
 /// @brief Main profiler class. Collects named Jam measurements and supports epoch averaging.
 class Jamanak {
+    template <typename Stage, size_t N>
+    friend class StageJamanak;
+    friend class FrameBudget;
 
 private:
     std::string global_context{"default"};   ///< Label shown in the report header.
-    std::vector<Jam> jams;                   ///< Jams recorded in the current epoch.
-    std::vector<std::vector<Jam>> epochs;    ///< Completed epochs for averaging.
-    std::shared_ptr<Jam> current_jam;        ///< The currently active Jam, if any.
+    Clock::time_point origin{Clock::now()};  ///< Time base of all packed timestamps.
+    std::vector<std::string> labels;         ///< Interned labels, indexed by PackedJam::label.
+    std::vector<std::uint32_t> label_slots;  ///< Open-addressing index of labels: id + 1 per slot, 0 = empty.
+    std::vector<PackedJam> jams;             ///< Jams recorded in the current epoch.
+    std::vector<Edge> edges;                 ///< Cross-thread edges of the current epoch.
+    std::vector<PackedJam> store;            ///< Jams of all completed epochs, back to back.
+    std::vector<Work> work;                  ///< Work annotations of the current epoch, by jam id.
+    std::vector<Work> work_store;            ///< Work annotations of all completed epochs, back to back.
+    std::vector<Epoch> epochs;               ///< Completed epochs for averaging.
+    std::vector<size_t> pending_joins;       ///< Joined lane tails awaiting a jam that starts after them.
+    size_t lane_count{0};                    ///< Lanes forked in the current epoch.
+    std::uint64_t generation{0};             ///< Bumped whenever the current epoch is cleared; stamps forked lanes.
+    std::int64_t epoch_t0{0};                ///< Wall-clock start of the current epoch (ns since origin).
+    bool epoch_open{false};                  ///< Whether epoch_t0 is set; else the first jam starts the epoch.
+    std::uint32_t current_label{0};          ///< Label id of the active measurement.
+    Clock::time_point current_t0{};          ///< Start of the active measurement.
     State jam_state{State::idle};            ///< Whether a measurement is in progress.
     size_t longest{0};                       ///< Longest context label (for alignment).
-    size_t longest_dur{0};                   ///< Longest duration string (for alignment).
-    size_t longest_bc{0};                    ///< Digits before decimal point (for alignment).
-
-    /// @brief Returns @p n repetitions of the string @p f.
-    std::string fence(const int n, const std::string f) {
-        std::ostringstream out;
-        for (size_t i = 0; i < n; i++) { out << f; }
-        return out.str();
+    std::shared_ptr<const Environment> env;  ///< Machine state recorded with the results, if any.
+    size_t dropped{0};                       ///< Epochs discarded by drop_epochs() since the last clean_epochs().
+    size_t saturated{0};                     ///< Jams clamped to the PackedJam limits since the last clean_epochs().
+    std::int64_t next_rebase{1ll << 47};     ///< Time (ns since origin) of the next rebase(); half the start range.
+
+    /// @brief Contiguous run of packed jams, e.g. one epoch of the store.
+    struct JamRange {
+        const PackedJam* first;                            ///< First jam.
+        size_t count;                                      ///< Number of jams.
+
+        const PackedJam* begin() const { return first; }
+        const PackedJam* end() const { return first + count; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const PackedJam& operator[](size_t i) const { return first[i]; }
+    };
+
+    /// @brief Returns the jams of a completed epoch.
+    JamRange range(const Epoch& ep) const { return {store.data() + ep.first, ep.count}; }
+
+    /// @brief Returns the jams of the current epoch.
+    JamRange current() const { return {jams.data(), jams.size()}; }
+
+    /// @brief Returns nanoseconds between the profiler's origin and @p t.
+    std::int64_t since_origin(Clock::time_point t) const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t - origin).count();
+    }
+
+    /// @brief Returns the interned id of @p context, adding it if new.
+    /// @throws std::runtime_error if the label table is full.
+    std::uint32_t intern(const std::string& context) {
+        if (!label_slots.empty()) {
+            const size_t mask = label_slots.size() - 1;
+            for (size_t i = std::hash<std::string>{}(context) & mask; label_slots[i]; i = (i + 1) & mask) {
+                if (labels[label_slots[i] - 1] == context) return label_slots[i] - 1;
+            }
+        }
+        return add_label(context);
+    }
+
+    /// @brief Interns a label not seen before, growing the index to stay at most half full.
+    /// @throws std::runtime_error if the label table is full.
+    std::uint32_t add_label(const std::string& context);
+
+    /// @brief Builds a packed record, clamping fields to their bit widths.
+    ///
+    /// A jam with any field out of range (including a start before the origin) is
+    /// counted in `saturated`, so the clamping never goes unreported.
+    PackedJam pack(std::uint32_t label, size_t thread, std::int64_t start_ns, std::int64_t dur_ns) {
+        const bool fits = start_ns >= 0 && static_cast<std::uint64_t>(start_ns) <= PackedJam::max_start &&
+                          dur_ns >= 0 && static_cast<std::uint64_t>(dur_ns) <= PackedJam::max_dur &&
+                          thread <= PackedJam::max_thread;
+        if (!fits) ++saturated;
+
+        const auto clamp = [](std::int64_t v, std::uint64_t hi) -> std::uint64_t {
+            return v < 0 ? 0 : static_cast<std::uint64_t>(v) > hi ? hi : static_cast<std::uint64_t>(v);
+        };
+        PackedJam p;
+        p.start_ns = clamp(start_ns, PackedJam::max_start);
+        p.thread   = thread > PackedJam::max_thread ? PackedJam::max_thread : thread;
+        p.dur_ns   = clamp(dur_ns, PackedJam::max_dur);
+        p.label    = label;
+        return p;
+    }
+
+    /// @brief Materializes the Jam view of a packed record.
+    Jam view(const PackedJam& p, size_t id) const {
+        Jam j;
+        j.context     = labels[p.label];
+        j.t0          = origin + std::chrono::nanoseconds(p.start_ns);
+        j.t1          = j.t0 + std::chrono::nanoseconds(p.dur_ns);
+        j.duration_ns = static_cast<std::int64_t>(p.dur_ns);
+        j.duration_ms = static_cast<double>(j.duration_ns) / 1e6;
+        j.thread      = p.thread;
+        j.id          = id;
+        return j;
     }
 
-    /// @brief Returns the number of characters before the decimal point in @p num.
-    size_t get_shift(const std::string num) {
-        auto idx = num.find(".");
-        auto s = num.substr(0, idx);
-        return s.size();
+    /// @brief Returns the end of @p p in ns since origin.
+    static std::int64_t end_of(const PackedJam& p) { return static_cast<std::int64_t>(p.start_ns + p.dur_ns); }
+
+    /// @brief Adds a join edge to jam @p id from every pending lane tail that ended by its start.
+    ///
+    /// Tails that end later stay pending: a jam already running when the lane was
+    /// joined does not depend on it.
+    void attach_joins(size_t id) {
+        const auto t0 = static_cast<std::int64_t>(jams[id].start_ns);
+        size_t k = 0;
+        for (size_t from : pending_joins) {
+            if (end_of(jams[from]) <= t0) edges.push_back({from, id, EdgeKind::join});
+            else pending_joins[k++] = from;
+        }
+        pending_joins.resize(k);
+    }
+
+    /// @brief Moves the origin forward once @p now is halfway to the packed start limit.
+    ///
+    /// Every packed start, epoch bound and epoch_t0 shifts by the same amount, so
+    /// reports do not change. The shift stops at the earliest stored start: a
+    /// long-running profiler keeps recording as long as old epochs are dropped.
+    /// @param now Current time in ns since origin.
+    /// @return The shift in ns; subtract it from times taken before the call.
+    std::int64_t rebase(std::int64_t now);
+
+    /// @brief Returns the wall-clock start of the current epoch in ns since origin.
+    std::int64_t wall_begin() const {
+        if (epoch_open || jams.empty()) return epoch_t0;
+        std::int64_t t = jams.front().start_ns;
+        for (const auto& j : jams) {
+            if (static_cast<std::int64_t>(j.start_ns) < t) t = j.start_ns;
+        }
+        return t;
     }
 
+    /// @brief Returns the time in nanoseconds covered by at least one jam of @p js.
+    ///
+    /// Overlapping jams (e.g. from parallel lanes) are counted once.
+    static std::int64_t covered_ns(JamRange js);
+
+    /// @brief Durations of every label, gathered in one sweep over the epoch store.
+    struct LabelSamples {
+        std::vector<std::string> labels;                   ///< Labels in order of first appearance.
+        std::vector<std::vector<double>> calls;            ///< Per label: duration of every call.
+        std::vector<std::vector<double>> series;           ///< Per label: summed duration in every epoch.
+        std::vector<double> items;                         ///< Per label: summed items over all epochs.
+        std::vector<double> bytes;                         ///< Per label: summed bytes over all epochs.
+    };
+
+    /// @brief Collects per-call samples and per-epoch sums for every label.
+    /// @param calls Whether to collect the per-call durations.
+    /// @param series Whether to build the dense per-epoch series.
+    LabelSamples gather(bool calls = true, bool series = true) const;
+
+    /// @brief Runs the stability analysis on already gathered samples.
+    static std::vector<LabelStability> stability(const LabelSamples& samples, const StabilityOptions& opts);
+
+    /// @brief Renders jams as a Gantt chart with one row per lane and label.
+    ///
+    /// Time is bucketed into @p width columns; each cell is shaded by the fraction
+    /// of the bucket covered by the row's jams, so any number of jams fits.
+    /// @param js Jams to draw.
+    /// @param b Start of the time axis, ns since origin.
+    /// @param e End of the time axis, ns since origin.
+    /// @param hdr Header line.
+    /// @param width Number of time buckets.
+    std::string timeline(JamRange js, std::int64_t b, std::int64_t e, const std::string& hdr, size_t width);
+
+    /// @brief Finds how the jams of each lane nest.
+    ///
+    /// A jam that starts before another one of its lane has ended is nested in it.
+    /// @param js Jams to analyse.
+    /// @param root Receives, per jam, the outermost jam of its lane that contains it, or the jam itself.
+    /// @param prev Receives, per top-level jam, the latest-ending jam of its lane that ended by its
+    ///             start; js.size() for nested jams and for the first jam of a lane.
+    static void nesting(JamRange js, std::vector<size_t>& root, std::vector<size_t>& prev);
+
+    /// @brief Computes earliest/latest finish times of every jam in @p ep.
+    /// @param ep Epoch to analyse.
+    /// @param ef Receives earliest finish times (ns since the start of the DAG).
+    /// @param lf Receives latest finish times that keep the critical path length.
+    /// @param pred Receives the predecessor on the longest path to each jam (or the jam itself).
+    /// @return Id of the last jam of the critical path.
+    /// @throws std::runtime_error if the edges contain a cycle.
+    size_t schedule(const Epoch& ep, std::vector<double>& ef, std::vector<double>& lf,
+                    std::vector<size_t>& pred) const;
+
 public:
     /// @brief Constructs a profiler with the given report header label.
     /// @param context Global label shown at the top of every report.
@@ -72,35 +400,66 @@ public:
     void start(const std::string& context) {
         if (jam_state == State::jamming) throw std::runtime_error("already jamming");
 
-        current_jam = std::make_shared<Jam>();
-        current_jam->context = context;
-        current_jam->t0 = std::chrono::high_resolution_clock::now();
+        current_label = intern(context);
         jam_state = State::jamming;
+        current_t0 = Clock::now();
     }
 
-    /// @brief Stops the current measurement, records it, and returns it.
-    /// @return Shared pointer to the completed Jam.
+    /// @brief Stops the current measurement and records it, without materializing a Jam.
+    ///
+    /// The allocation-free counterpart of end() for hot loops: it only appends a
+    /// packed record.
+    /// @return Id of the jam within the current epoch.
     /// @throws std::runtime_error if no measurement is active.
-    std::shared_ptr<Jam> end() {
-        if (jam_state == State::idle || !current_jam) throw std::runtime_error("jamming not started");
+    size_t stop() {
+        auto t1 = Clock::now();
+        if (jam_state == State::idle) throw std::runtime_error("jamming not started");
 
-        current_jam->t1 = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double, std::milli> ms_double = current_jam->t1 - current_jam->t0;
-        current_jam->duration_ms = ms_double.count();
+        const size_t id = jams.size();
+        jams.push_back(pack(current_label, 0, since_origin(current_t0),
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - current_t0).count()));
 
-        jams.emplace_back(*current_jam);
-        longest = std::max(longest, current_jam->context.size());
+        if (!pending_joins.empty()) attach_joins(id);
+        jam_state = State::idle;
 
-        std::ostringstream ss;
-        ss << std::fixed << std::setprecision(5) << current_jam->duration_ms;
-        std::string s = ss.str();
-        longest_dur = std::max(longest_dur, s.size());
-        longest_bc = std::max(longest_bc, get_shift(s));
+        return id;
+    }
 
-        auto ret = current_jam;
-        current_jam.reset();
-        jam_state = State::idle;
+    /// @brief Stops the current measurement, annotates it with the work it did, and records it.
+    ///
+    /// Throughput is reported as summed work over summed time per label.
+    /// @param items Items (records, elements, ...) processed.
+    /// @param bytes Bytes processed.
+    /// @return Id of the jam within the current epoch.
+    /// @throws std::runtime_error if no measurement is active.
+    size_t stop(std::uint64_t items, std::uint64_t bytes = 0) {
+        const size_t id = stop();
+        work.push_back({id, items, bytes});
+        return id;
+    }
 
+    /// @brief Stops the current measurement, records it, and returns it.
+    ///
+    /// Allocates the returned Jam; use stop() where the result is not needed.
+    /// @return Shared pointer to the completed Jam.
+    /// @throws std::runtime_error if no measurement is active.
+    std::shared_ptr<Jam> end() {
+        const size_t id = stop();
+        return std::make_shared<Jam>(view(jams[id], id));
+    }
+
+    /// @brief Stops the current measurement and annotates it with the work it did.
+    ///
+    /// Throughput is reported as summed work over summed time per label.
+    /// @param items Items (records, elements, ...) processed.
+    /// @param bytes Bytes processed.
+    /// @return Shared pointer to the completed Jam.
+    /// @throws std::runtime_error if no measurement is active.
+    std::shared_ptr<Jam> end(std::uint64_t items, std::uint64_t bytes = 0) {
+        const size_t id = stop(items, bytes);
+        auto ret = std::make_shared<Jam>(view(jams[id], id));
+        ret->items = items;
+        ret->bytes = bytes;
         return ret;
     }
 
@@ -109,16 +468,28 @@ public:
     void begin_epoch() {
         if (jam_state == State::jamming) throw std::runtime_error("cannot begin epoch while jamming");
         clean_jams();
+        const auto now = since_origin(Clock::now());
+        epoch_t0 = now - rebase(now);
+        epoch_open = true;
     }
 
     /// @brief Saves the current jams as a completed epoch, then clears them.
+    ///
+    /// The epoch's wall time runs from begin_epoch() (or the end of the previous
+    /// epoch, or else the first jam) until now; the next epoch starts right away.
     /// @throws std::runtime_error if a measurement is in progress.
     void end_epoch() {
         if (jam_state == State::jamming) throw std::runtime_error("cannot end epoch while jamming");
+        auto now = since_origin(Clock::now());
+        now -= rebase(now);
         if (!jams.empty()) {
-            epochs.emplace_back(jams);
+            epochs.push_back({store.size(), jams.size(), edges, wall_begin(), now, work_store.size(), work.size()});
+            store.insert(store.end(), jams.begin(), jams.end());
+            work_store.insert(work_store.end(), work.begin(), work.end());
         }
         clean_jams();
+        epoch_t0 = now;
+        epoch_open = true;
     }
 
     /// @brief Discards the current jams without saving them as an epoch.
@@ -126,176 +497,367 @@ public:
     void cancel_epoch() {
         if (jam_state == State::jamming) throw std::runtime_error("cannot cancel epoch while jamming");
         clean_jams();
+        const auto now = since_origin(Clock::now());
+        epoch_t0 = now - rebase(now);
+        epoch_open = true;
     }
 
     /// @brief Clears all saved epochs and current jams.
     void clean_epochs() {
         epochs.clear();
+        store.clear();
+        work_store.clear();
         clean_jams();
+        epoch_open = false;
+        dropped = 0;
+        saturated = 0;
     }
 
     /// @brief Returns the number of completed epochs.
     size_t epoch_count() const { return epochs.size(); }
 
+    /// @brief Returns the summed jam time of every completed epoch in nanoseconds.
+    std::vector<double> epoch_totals() const;
+
+    /// @brief Finds the first epoch of the steady state.
+    ///
+    /// The steady state starts at the first sliding window of epoch totals whose
+    /// coefficient of variation is at most `opts.max_cv`; the epochs before it are
+    /// warmup (cold caches, frequency ramp-up, lazy initialisation).
+    /// @param opts Window length and CV threshold.
+    /// @return Index of the first steady epoch; epoch_count() if no window is steady yet.
+    size_t steady_epoch(const SteadyOptions& opts) const;
+
+    /// @brief Finds the first epoch of the steady state with the default SteadyOptions.
+    size_t steady_epoch() const;
+
+    /// @brief Discards the first @p n completed epochs from all statistics and reports.
+    /// @return Number of epochs discarded (at most epoch_count()).
+    size_t drop_epochs(size_t n);
+
+    /// @brief Detects the warmup with steady_epoch() and discards it.
+    ///
+    /// Nothing is dropped if no steady window is found.
+    /// @return Number of epochs discarded.
+    size_t drop_warmup(const SteadyOptions& opts);
+
+    /// @brief Detects the warmup with the default SteadyOptions and discards it.
+    size_t drop_warmup();
+
+    /// @brief Returns the number of epochs discarded by drop_epochs() or drop_warmup().
+    size_t dropped_epochs() const { return dropped; }
+
+    /// @brief Returns the number of jams clamped to the PackedJam limits since the last clean_epochs().
+    ///
+    /// Non-zero means some recorded start, duration or lane is wrong (e.g. a jam
+    /// longer than ~18.3 minutes); reports and to_json() show the count.
+    size_t saturated_jams() const { return saturated; }
+
+    /// @brief Returns the wall time of the current epoch in nanoseconds, up to the end of its last jam.
+    std::int64_t wall_ns() const {
+        if (jams.empty()) return 0;
+        std::int64_t t1 = 0;
+        for (const auto& j : jams) {
+            if (end_of(j) > t1) t1 = end_of(j);
+        }
+        return t1 - wall_begin();
+    }
+
+    /// @brief Returns the time of the current epoch not covered by any jam, in nanoseconds.
+    std::int64_t untracked_ns() const;
+
+    /// @brief Returns the mean wall time of the completed epochs in nanoseconds.
+    double epoch_wall_ns() const {
+        if (epochs.empty()) return 0.0;
+        std::int64_t sum = 0;
+        for (const auto& ep : epochs) sum += ep.end_ns - ep.begin_ns;
+        return static_cast<double>(sum) / static_cast<double>(epochs.size());
+    }
+
+    /// @brief Returns the mean untracked (gap) time of the completed epochs in nanoseconds.
+    double epoch_untracked_ns() const;
+
     /// @brief Computes per-label average durations across all epochs.
     /// @return Vector of Jams with averaged `duration_ms`; empty if no epochs exist.
     /// @note Assumes every epoch contains the same number of jams in the same order.
-    std::vector<Jam> epoch_averages() const {
-        if (epochs.empty()) return {};
-
-        const size_t jam_count = epochs[0].size();
-        const double n = static_cast<double>(epochs.size());
-        std::vector<Jam> avgs(jam_count);
-
-        for (size_t i = 0; i < jam_count; ++i) {
-            avgs[i].context = epochs[0][i].context;
-            double sum = 0.0;
-            for (const auto& ep : epochs) sum += ep[i].duration_ms;
-            avgs[i].duration_ms = sum / n;
-        }
+    std::vector<Jam> epoch_averages() const;
+
+    /// @brief Computes per-label distribution statistics over all jams of all epochs.
+    ///
+    /// Durations are gathered per label in a single sweep; moments come from one
+    /// Welford pass and percentiles from the sorted samples (linear interpolation).
+    /// @return One entry per label, in order of first appearance; empty if no epochs exist.
+    std::vector<LabelStats> label_stats() const;
+
+    /// @brief Computes label_stats() with bootstrap confidence intervals of the means and medians.
+    ///
+    /// The time per epoch is resampled over epochs, the per-call mean and median over
+    /// calls; intervals are percentiles of the resampled statistics. Labels and
+    /// blocks of resamples are spread over worker threads, each block with its own
+    /// xoshiro256+ stream, so the result is the same for any thread count.
+    /// @param opts Resample count, confidence level, seed and threads.
+    std::vector<LabelStats> label_stats(const BootstrapOptions& opts) const;
+
+    /// @brief Returns every label's summed duration per epoch, in the order of label_stats().
+    std::vector<std::vector<double>> label_series() const { return gather(false, true).series; }
 
-        return avgs;
-    }
+private:
+    /// @brief Computes label statistics in one streaming pass over the store; percentiles are left at zero.
+    std::vector<LabelStats> label_moments() const;
 
-    /// @brief Clears all jams in the current (unsaved) epoch.
-    void clean_jams() { jams.clear(); }
+    /// @brief Fills the percentiles of @p stats from gathered per-call samples; sorts them in place.
+    static void percentiles(LabelSamples& samples, std::vector<LabelStats>& stats);
 
-    /// @brief Returns a copy of all jams in the current epoch.
-    std::vector<Jam> get_jams() const { return jams; }
+    /// @brief Fills the bootstrap intervals of @p stats from gathered @p samples.
+    static void bootstrap(const LabelSamples& samples, std::vector<LabelStats>& stats, const BootstrapOptions& opts);
 
-    /// @brief Returns true if a measurement is currently in progress.
-    bool is_jamming() const { return jam_state == State::jamming; }
+public:
 
-    /// @brief Renders a formatted ANSI report of all jams in the current epoch.
-    /// @return Multi-line string with timing table and total.
-    std::string to_string() {
-        std::ostringstream out;
-        size_t l_size = std::max(longest + longest_dur, global_context.size()) + 13;
-        size_t sf_size = static_cast<size_t>(l_size / 2) - static_cast<size_t>(global_context.size() / 2);
-        size_t j_context_size{0};
-
-        auto old_flags = out.flags();
-        auto old_prec  = out.precision();
-
-        out << ANSI_BOLD << ANSI_RGB(227,225,127);
-        out << fence(l_size, "–") << "\n";
-        out << fence(sf_size, " ");
-        out << global_context.c_str();
-        out << "\n";
-        out << fence(l_size, "–") << "\n";
-
-        double total = 0.0;
-        for (const auto& j : jams) {
-            j_context_size = j.context.size();
-            std::ostringstream ss;
-            ss << std::fixed << std::setprecision(5) << j.duration_ms;
-            std::string s = ss.str();
-
-            out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
-            out << ANSI_BOLD << ANSI_RGB(143,227,125) << j.context.c_str() << ANSI_RESET;
-            out << fence(longest - j_context_size + 2, "–") << ": ";
-            out << ANSI_BOLD << ANSI_RGB(143,227,125);
-            out << fence(longest_bc - get_shift(s), " ") << s << ANSI_RESET;
-            out << " ms";
-            out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
-
-            total += j.duration_ms;
-        }
+    /// @brief Forks a lane for work running on another thread.
+    ///
+    /// The first jam recorded on the lane depends on the last jam this profiler
+    /// recorded (spawn edge). Drive the lane from the worker thread, then hand it
+    /// back with join() before the current epoch ends.
+    /// @return A fresh lane with its own thread index.
+    Lane fork() {
+        return Lane(++lane_count, !jams.empty(), jams.empty() ? 0 : jams.size() - 1, generation);
+    }
 
-        std::ostringstream tot_ss;
-        tot_ss << std::fixed << std::setprecision(5) << total;
-        std::string tot_str = tot_ss.str();
-        size_t safe_bc = std::max(longest_bc, get_shift(tot_str));
+    /// @brief Merges a finished lane into the current epoch.
+    ///
+    /// The next jam recorded on this profiler that starts after the lane's last jam
+    /// ended depends on it (join edge); jams already running at that point do not.
+    /// @param lane Lane returned by fork() in the current epoch; its jams are moved out.
+    /// @throws std::runtime_error if the lane is still jamming or was forked before the
+    ///         current epoch began (begin_epoch(), end_epoch(), cancel_epoch() or clean_jams()).
+    void join(Lane& lane) {
+        if (lane.is_jamming()) throw std::runtime_error("cannot join lane while jamming");
+        if (lane.generation != generation) throw std::runtime_error("cannot join lane forked in another epoch");
+        if (lane.jams.empty()) return;
+
+        const size_t offset = jams.size();
+        for (const auto& j : lane.jams) {
+            if (j.items || j.bytes) work.push_back({jams.size(), j.items, j.bytes});
+            jams.push_back(pack(intern(j.context), j.thread, since_origin(j.t0), j.duration_ns));
+        }
+        if (lane.has_parent) edges.push_back({lane.parent, offset, EdgeKind::spawn});
+        pending_joins.push_back(jams.size() - 1);
+        lane.jams.clear();
+    }
 
-        out << ANSI_BOLD << ANSI_RGB(227,225,127);
-        out << fence(l_size, "–") << "\n";
-        out << "|| total ──: ";
-        out << ANSI_RGB(143,227,125);
-        out << fence(safe_bc - get_shift(tot_str), " ") << tot_str << ANSI_RESET;
-        out << " ms";
-        out << ANSI_BOLD << ANSI_RGB(227,225,127) << "\n";
-        out << fence(l_size, "–") << ANSI_RESET << "\n";
+    /// @brief Adds an explicit dependency between two jams of the current epoch.
+    /// @param from Id of the jam that must finish first.
+    /// @param to Id of the dependent jam.
+    /// @param kind Edge kind, for bookkeeping.
+    /// @throws std::runtime_error if either id is unknown.
+    void link(size_t from, size_t to, EdgeKind kind = EdgeKind::spawn) {
+        if (from >= jams.size() || to >= jams.size()) throw std::runtime_error("edge refers to unknown jam");
+        edges.push_back({from, to, kind});
+    }
 
-        out.flags(old_flags);
-        out.precision(old_prec);
+    /// @brief Adds an already measured jam to the current epoch.
+    ///
+    /// For backends that time work themselves (e.g. compiler instrumentation).
+    /// Jams may overlap; nested ones are counted once in the untracked time. Like
+    /// stop(), it takes the join edges of lane tails that ended by @p t0.
+    /// @param context Label of the jam.
+    /// @param t0 Start time.
+    /// @param t1 End time.
+    /// @param thread Lane index to file the jam under (0 = owning thread).
+    /// @return Id of the recorded jam.
+    size_t record(const std::string& context, Clock::time_point t0, Clock::time_point t1, size_t thread = 0) {
+        return record(intern(context), t0, t1, thread);
+    }
 
-        return out.str();
+    /// @brief Adds an already measured jam under a label interned with label_id().
+    ///
+    /// The hashing-free counterpart of record() for hot loops.
+    /// @param label Id returned by label_id() on this profiler.
+    /// @param t0 Start time.
+    /// @param t1 End time.
+    /// @param thread Lane index to file the jam under (0 = owning thread).
+    /// @return Id of the recorded jam.
+    /// @throws std::runtime_error if @p label is not a label of this profiler.
+    size_t record(std::uint32_t label, Clock::time_point t0, Clock::time_point t1, size_t thread = 0) {
+        if (label >= labels.size()) throw std::runtime_error("unknown label id");
+
+        const size_t id = jams.size();
+        jams.push_back(pack(label, thread, since_origin(t0),
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+        if (!pending_joins.empty()) attach_joins(id);
+        return id;
     }
 
-    /// @brief Renders a formatted ANSI report of epoch averages, including percentage breakdown.
-    /// @return Multi-line string with averaged timing table and total; empty string if no epochs.
-    std::string to_string_epochs() {
-        if (epochs.empty()) return "";
-
-        auto avgs = epoch_averages();
-        double total = 0.0;
-        for (const auto& a : avgs) total += a.duration_ms;
-
-        size_t l_ctx{0}, l_bc{0}, l_dur{0};
-        std::vector<std::string> dur_strs;
-
-        for (const auto& a : avgs) {
-            l_ctx = std::max(l_ctx, a.context.size());
-            std::ostringstream ss;
-            ss << std::fixed << std::setprecision(5) << a.duration_ms;
-            std::string s = ss.str();
-            dur_strs.push_back(s);
-            l_dur = std::max(l_dur, s.size());
-            l_bc  = std::max(l_bc,  get_shift(s));
+    /// @brief Returns the interned id of @p context, adding it if new; ids stay valid for the profiler's lifetime.
+    /// @throws std::runtime_error if the label table is full.
+    std::uint32_t label_id(const std::string& context) { return intern(context); }
+
+    /// @brief Appends a completed epoch recorded elsewhere, e.g. by a child process.
+    ///
+    /// Jams keep their timestamps, lanes and work annotations; edges are not
+    /// carried over. The current epoch, including its lanes and pending join edges,
+    /// is left untouched. Empty epochs are skipped, as in end_epoch().
+    /// @param js Jams of the epoch; context, t0, t1, thread, items and bytes are used.
+    /// @param begin Wall-clock start of the epoch.
+    /// @param end Wall-clock end of the epoch.
+    void import_epoch(const std::vector<Jam>& js, Clock::time_point begin, Clock::time_point end) {
+        if (js.empty()) return;
+
+        rebase(since_origin(begin));
+        Epoch ep{store.size(), js.size(), {}, since_origin(begin), since_origin(end), work_store.size(), 0};
+        for (size_t i = 0; i < js.size(); ++i) {
+            const auto& j = js[i];
+            store.push_back(pack(intern(j.context), j.thread, since_origin(j.t0),
+                                 std::chrono::duration_cast<std::chrono::nanoseconds>(j.t1 - j.t0).count()));
+            if (j.items || j.bytes) work_store.push_back({i, j.items, j.bytes});
         }
+        ep.work_count = work_store.size() - ep.work_first;
+        epochs.push_back(std::move(ep));
+    }
 
-        std::ostringstream tot_ss;
-        tot_ss << std::fixed << std::setprecision(5) << total;
-        std::string tot_str = tot_ss.str();
-        l_bc = std::max(l_bc, get_shift(tot_str));
-
-        std::string hdr = global_context + "  [" + std::to_string(epochs.size()) + " epochs]";
-        size_t l_size = std::max(l_ctx + l_dur, hdr.size()) + 25;
-        size_t sf_size = l_size / 2;
-        if (hdr.size() / 2 < sf_size) sf_size -= hdr.size() / 2;
-        else sf_size = 0;
-
-        std::ostringstream out;
-        auto old_flags = out.flags();
-        auto old_prec  = out.precision();
-
-        out << ANSI_BOLD << ANSI_RGB(227,225,127);
-        out << fence(l_size, "–") << "\n";
-        out << fence(sf_size, " ") << hdr << "\n";
-        out << fence(l_size, "–") << "\n";
-
-        for (size_t i = 0; i < avgs.size(); ++i) {
-            const auto& a   = avgs[i];
-            const auto& s   = dur_strs[i];
-            double pct      = total > 0.0 ? (a.duration_ms / total * 100.0) : 0.0;
-
-            std::ostringstream pct_ss;
-            pct_ss << std::fixed << std::setprecision(1) << pct;
-
-            out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
-            out << ANSI_BOLD << ANSI_RGB(143,227,125) << a.context.c_str() << ANSI_RESET;
-            out << fence(l_ctx - a.context.size() + 2, "–") << ": ";
-            out << ANSI_BOLD << ANSI_RGB(143,227,125);
-            out << fence(l_bc - get_shift(s), " ") << s << ANSI_RESET;
-            out << " ms  ";
-            out << ANSI_DIM << "(" << pct_ss.str() << "%)" << ANSI_RESET;
-            out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+    /// @brief Returns the jam ids on the critical path of a completed epoch, in execution order.
+    /// @param epoch Index of the epoch.
+    /// @throws std::out_of_range if @p epoch does not exist.
+    std::vector<size_t> critical_path(size_t epoch) const;
+
+    /// @brief Finds level shifts and drift in every label's time per epoch.
+    ///
+    /// Change points are placed by PELT on a Gaussian mean-shift cost, with the noise
+    /// level estimated robustly from successive differences; drift is the
+    /// least-squares slope over all epochs. Labels without either are still listed.
+    /// @param opts Penalty, minimum segment length and reporting thresholds.
+    /// @return One entry per label, in order of first appearance; empty if no epochs.
+    std::vector<LabelStability> stability(const StabilityOptions& opts) const;
+
+    /// @brief Finds level shifts and drift with the default StabilityOptions.
+    std::vector<LabelStability> stability() const;
+
+    /// @brief Decomposes the variance of the epoch wall time into per-label contributions.
+    ///
+    /// One pass over the epoch store: each epoch's wall time is split into per-label
+    /// exclusive times (see JitterContributor) in a dense row indexed by label id, and
+    /// running co-moments with the wall time are updated column by column. Epochs
+    /// with lanes pay for one critical path analysis each.
+    /// @return Contributors ranked by share, largest first, including "untracked";
+    ///         empty if there are fewer than two epochs.
+    std::vector<JitterContributor> jitter_contributors() const;
+
+    /// @brief Returns the mean critical path length across all epochs in nanoseconds.
+    double critical_path_ns() const;
+
+    /// @brief Computes per-label critical path membership and slack across all epochs.
+    /// @return One entry per label, in order of first appearance.
+    std::vector<CriticalLabel> critical_labels() const;
+
+    /// @brief Reserves room for @p n jams in the current epoch, so recording them does not allocate.
+    void reserve(size_t n) { jams.reserve(n); }
+
+    /// @brief Returns the number of jams recorded in the current epoch so far.
+    size_t jam_count() const { return jams.size(); }
+
+    /// @brief Clears all jams in the current (unsaved) epoch.
+    ///
+    /// Lanes forked before can no longer be joined.
+    void clean_jams() {
+        jams.clear();
+        edges.clear();
+        work.clear();
+        pending_joins.clear();
+        lane_count = 0;
+        ++generation;
+    }
+
+    /// @brief Returns a copy of all jams in the current epoch.
+    std::vector<Jam> get_jams() const {
+        std::vector<Jam> out;
+        out.reserve(jams.size());
+        for (size_t i = 0; i < jams.size(); ++i) out.push_back(view(jams[i], i));
+        for (const auto& w : work) {
+            out[w.jam].items = w.items;
+            out[w.jam].bytes = w.bytes;
         }
+        return out;
+    }
+
+    /// @brief Returns true if a measurement is currently in progress.
+    bool is_jamming() const { return jam_state == State::jamming; }
 
-        out << ANSI_BOLD << ANSI_RGB(227,225,127);
-        out << fence(l_size, "–") << "\n";
-        out << "|| total ──: ";
-        out << ANSI_RGB(143,227,125);
-        out << fence(l_bc - get_shift(tot_str), " ") << tot_str << ANSI_RESET;
-        out << " ms";
-        out << ANSI_BOLD << ANSI_RGB(227,225,127) << "\n";
-        out << fence(l_size, "–") << ANSI_RESET << "\n";
+    /// @brief Renders a formatted ANSI report of all jams in the current epoch.
+    /// @param unit Unit of the durations; `automatic` picks one from the longest jam.
+    /// @return Multi-line string with timing table, untracked gap time, total and wall time.
+    std::string to_string(Unit unit = Unit::automatic);
+
+    /// @brief Renders a formatted ANSI report of per-label epoch averages, including percentage breakdown.
+    ///
+    /// Rows are labels in order of first appearance; the mean is the label's average
+    /// time per epoch. Percentages are relative to the mean epoch wall time; the time
+    /// not covered by any jam is shown as its own "untracked" row.
+    /// @param opts Unit, optional distribution columns and noise highlighting.
+    /// @return Multi-line string with averaged timing table, total and wall time; empty string if no epochs.
+    std::string to_string_epochs(const ReportOptions& opts);
+
+    /// @brief Renders the epoch report with the default ReportOptions.
+    std::string to_string_epochs();
+
+    /// @brief Exports all completed epochs as JSON.
+    ///
+    /// Contains the report context, the epoch count, mean wall and untracked time,
+    /// every field of label_stats() and the recorded environment (if any).
+    /// @return JSON object as a string.
+    std::string to_json() const;
+
+    /// @brief Records the machine state the results were measured under.
+    ///
+    /// It is printed below the epoch report and included in to_json().
+    void set_environment(const Environment& environment);
+
+    /// @brief Returns the recorded machine state; `probed` is false if none was set.
+    const Environment& environment() const;
 
-        out.flags(old_flags);
-        out.precision(old_prec);
+private:
+    /// @brief Renders the per-label epoch table shared by to_string_epochs() and StageJamanak.
+    /// @param context Report title.
+    /// @param n_epochs Number of averaged epochs.
+    /// @param stats Per-label statistics; an "untracked" row is appended.
+    /// @param samples Sorted per-call samples and per-epoch series for the shape cells, or nullptr.
+    /// @param wall Mean epoch wall time in nanoseconds.
+    /// @param untracked Mean untracked time per epoch in nanoseconds.
+    /// @param opts Unit, columns and shapes; shapes are skipped without @p samples.
+    /// @param n_dropped Number of discarded warmup epochs, noted in the header if non-zero.
+    static std::string render_epochs(const std::string& context, size_t n_epochs, std::vector<LabelStats> stats,
+                                     const LabelSamples* samples, double wall, double untracked,
+                                     ReportOptions opts, size_t n_dropped = 0);
+
+    /// @brief Converts StageJamanak moments to label statistics, skipping stages that never ran.
+    static std::vector<LabelStats> stage_stats(const char* const* names, const StageMoments* moments,
+                                               size_t n, size_t n_epochs);
+
+    /// @brief Renders a StageJamanak report; percentile columns are dropped.
+    static std::string render_stages(const char* context, const char* const* names, const StageMoments* moments,
+                                     size_t n, size_t n_epochs, double wall, double untracked,
+                                     const ReportOptions& opts);
 
-        return out.str();
-    }
+public:
+
+    /// @brief Renders the current epoch as a terminal Gantt chart.
+    ///
+    /// One row per label and lane; gaps, overlaps between lanes and serialized
+    /// phases show up as blank, stacked or staircase bars.
+    /// @param width Number of time buckets on the horizontal axis.
+    /// @return Multi-line string; empty string if the current epoch has no jams.
+    std::string to_timeline(size_t width = 64);
+
+    /// @brief Renders a completed epoch as a terminal Gantt chart.
+    /// @param epoch Index of the epoch.
+    /// @param width Number of time buckets on the horizontal axis.
+    /// @throws std::out_of_range if @p epoch does not exist.
+    std::string to_timeline_epoch(size_t epoch, size_t width = 64);
+
+    /// @brief Renders a formatted ANSI report of critical path membership and slack per label.
+    /// @param unit Unit of the durations; `automatic` picks one from the critical path length.
+    /// @return Multi-line string with per-label critical path share and mean slack, followed by
+    ///         the mean critical path length and the mean sum of jams; empty string if no epochs.
+    std::string to_string_critical_path(Unit unit = Unit::automatic);
 
 };
 
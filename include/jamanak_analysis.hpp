@@ -0,0 +1,147 @@
+#pragma once
+
+#include "jamanak.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @file jamanak_analysis.hpp
+/// @brief Result and option types of the statistics, stability and jitter analyses.
+///
+/// Include it to read label_stats(), critical_labels() or the other analyses, or to
+/// pass options to the reports; recording only needs jamanak.hpp.
+
+namespace jamanak {
+
+/// @brief Per-label critical path statistics across all epochs.
+struct CriticalLabel {
+    std::string context;                                   ///< Label.
+    size_t on_path{0};                                     ///< Epochs in which the label lay on the critical path.
+    double mean_slack_ns{0.0};                             ///< Mean slack of the label's jams.
+};
+
+/// @brief Per-label distribution of jam durations across all epochs.
+struct LabelStats {
+    std::string context;                                   ///< Label.
+    size_t count{0};                                       ///< Number of jams (calls).
+    double epoch_ns{0.0};                                  ///< Mean time per epoch.
+    double mean_ns{0.0};                                   ///< Mean time per call.
+    double min_ns{0.0};                                    ///< Fastest call.
+    double max_ns{0.0};                                    ///< Slowest call.
+    double stddev_ns{0.0};                                 ///< Sample standard deviation per call.
+    double cv{0.0};                                        ///< Coefficient of variation (stddev / mean).
+    double p50_ns{0.0};                                    ///< Median call.
+    double p95_ns{0.0};                                    ///< 95th percentile call.
+    double p99_ns{0.0};                                    ///< 99th percentile call.
+    double calls_per_s{0.0};                               ///< Calls per second of time spent in the label.
+    double items_per_s{0.0};                               ///< Summed items over summed time in the label.
+    double bytes_per_s{0.0};                               ///< Summed bytes over summed time in the label.
+    double epoch_lo_ns{0.0};                               ///< Bootstrap CI of epoch_ns, lower bound (0 if not computed).
+    double epoch_hi_ns{0.0};                               ///< Bootstrap CI of epoch_ns, upper bound.
+    double mean_lo_ns{0.0};                                ///< Bootstrap CI of mean_ns, lower bound.
+    double mean_hi_ns{0.0};                                ///< Bootstrap CI of mean_ns, upper bound.
+    double p50_lo_ns{0.0};                                 ///< Bootstrap CI of p50_ns, lower bound.
+    double p50_hi_ns{0.0};                                 ///< Bootstrap CI of p50_ns, upper bound.
+};
+
+/// @brief Parameters of the bootstrap confidence intervals of label_stats().
+struct BootstrapOptions {
+    size_t resamples{2000};                                ///< Resamples per label.
+    double confidence{0.95};                               ///< Confidence level of the percentile intervals.
+    std::uint64_t seed{1};                                 ///< PRNG seed; results do not depend on the thread count.
+    size_t threads{0};                                     ///< Worker threads; 0 = hardware concurrency.
+};
+
+/// @brief Optional distribution columns of to_string_epochs(), combinable as a bitmask.
+enum Column : unsigned {
+    col_count      = 1u << 0,
+    col_min        = 1u << 1,
+    col_max        = 1u << 2,
+    col_stddev     = 1u << 3,
+    col_cv         = 1u << 4,
+    col_p50        = 1u << 5,
+    col_p95        = 1u << 6,
+    col_p99        = 1u << 7,
+    col_throughput = 1u << 8,
+    col_items      = 1u << 9,
+    col_bytes      = 1u << 10,
+    col_all        = (1u << 11) - 1,
+};
+
+/// @brief Rendering options for to_string_epochs().
+struct ReportOptions {
+    Unit unit{Unit::automatic};                            ///< Unit of all durations in the table.
+    unsigned columns{0};                                   ///< Bitmask of Column values to show.
+    double noisy_cv{0.25};                                 ///< Labels with a higher CV are highlighted.
+    bool histogram{false};                                 ///< Append a block-character histogram of call durations.
+    bool sparkline{false};                                 ///< Append a sparkline of the label's time per epoch.
+    size_t histogram_bins{12};                             ///< Histogram width in characters.
+    size_t sparkline_width{24};                            ///< Maximum sparkline width; epochs are bucketed beyond it.
+    bool stability{false};                                 ///< Append a section of change points and drift per label.
+    bool jitter{false};                                    ///< Append the ranked table of jitter contributors.
+    size_t bootstrap{0};                                   ///< Bootstrap resamples for "mean ± ci"; 0 = no intervals.
+    double confidence{0.95};                               ///< Confidence level of the bootstrap intervals.
+};
+
+/// @brief One label's part in the epoch-to-epoch variance of the wall time.
+///
+/// Each epoch's wall time is split without overlap: every instant covered by a jam
+/// goes to one label (the innermost of nested jams; across lanes, the jam on the
+/// critical path), the rest is untracked. Var(wall) = Σ Cov(label, wall) plus
+/// Cov(untracked, wall), so the shares of all contributors sum to one.
+struct JitterContributor {
+    std::string context;                                   ///< Label; "untracked" for the wall time no jam covers.
+    double stddev_ns{0.0};                                 ///< Standard deviation of the label's time per epoch.
+    double covariance{0.0};                                ///< Covariance with the epoch wall time, ns².
+    double correlation{0.0};                               ///< Pearson correlation with the epoch wall time.
+    double share{0.0};                                     ///< covariance / Var(wall); may be negative for compensating labels.
+};
+
+/// @brief Parameters of the change-point and drift analysis of per-label epoch series.
+struct StabilityOptions {
+    double penalty{3.0};                                   ///< PELT penalty per change, in units of σ² · ln(epochs).
+    size_t min_segment{5};                                 ///< Fewest epochs between two change points.
+    double min_shift{0.05};                                ///< Ignore changes and drifts smaller than this fraction of the mean.
+    double drift_t{4.0};                                   ///< t-statistic a trend slope needs to count as drift.
+};
+
+/// @brief A shift in a label's mean time per epoch.
+struct ChangePoint {
+    size_t epoch{0};                                       ///< First epoch of the new level (index among the kept epochs).
+    double before_ns{0.0};                                 ///< Mean time per epoch of the preceding segment.
+    double after_ns{0.0};                                  ///< Mean time per epoch of the following segment.
+};
+
+/// @brief Change points and drift of one label across the epoch history.
+struct LabelStability {
+    std::string context;                                   ///< Label.
+    std::vector<ChangePoint> changes;                      ///< Level shifts, in epoch order.
+    double slope_ns{0.0};                                  ///< Least-squares trend of the time per epoch, ns per epoch.
+    double slope_t{0.0};                                   ///< t-statistic of the slope.
+    bool drifting{false};                                  ///< Whether the trend is significant and large enough.
+};
+
+/// @brief Parameters of steady-state detection on per-epoch totals.
+struct SteadyOptions {
+    size_t window{5};                                      ///< Epochs per sliding window.
+    double max_cv{0.05};                                   ///< A window with at most this CV counts as steady.
+};
+
+/// @brief Machine state a benchmark ran under, as probed by a jamanak::Session.
+struct Environment {
+    bool probed{false};                                    ///< Whether the fields below were filled in.
+    std::string host;                                      ///< Host name.
+    std::string cpu_model;                                 ///< CPU model name.
+    size_t cpus{0};                                        ///< Online CPUs.
+    int cpu{-1};                                           ///< CPU the measuring thread was pinned to; -1 = not pinned.
+    std::string siblings;                                  ///< SMT siblings sharing a core with cpu (sysfs list), empty if none.
+    int nice{0};                                           ///< Nice value of the measuring thread.
+    std::string governor;                                  ///< cpufreq scaling governor of cpu; empty if unknown.
+    int turbo{-1};                                         ///< Turbo/boost state: 1 on, 0 off, -1 unknown.
+    double load[3]{0.0, 0.0, 0.0};                         ///< 1, 5 and 15 minute load averages.
+    std::vector<std::string> warnings;                     ///< Conditions likely to add noise.
+};
+
+} // namespace jamanak
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "jamanak.hpp"
+
+/// @file jamanak_instrument.hpp
+/// @brief Whole-program timing through GCC/Clang `-finstrument-functions`.
+///
+/// Link the `jamanak::instrument` library and compile the targets to profile with
+/// `-finstrument-functions` (see `jamanak_instrument()` in cmake/JamanakInstrument.cmake).
+/// Every instrumented function entry and exit is then timed into a per-thread
+/// buffer; collect() symbolizes the addresses and hands the calls to a profiler.
+
+namespace jamanak {
+namespace instrument {
+
+/// @brief How collect() measures a call.
+enum Timing {
+    inclusive,  ///< Entry to exit, including nested calls.
+    self,       ///< Entry to exit minus the time spent in nested instrumented calls.
+};
+
+/// @brief Resumes recording on all threads (recording is on by default).
+void enable();
+
+/// @brief Stops recording on all threads; calls already in flight are still closed.
+void disable();
+
+/// @brief Returns whether recording is on.
+bool enabled();
+
+/// @brief Moves all buffered calls into the current epoch of @p profiler.
+///
+/// Addresses are mapped to demangled names with `dladdr` (executables need
+/// `-rdynamic`); unknown ones show up as hex addresses. The calling thread becomes
+/// lane 0; every other thread with buffered calls becomes lane 1, 2, ... in order
+/// of its first call, counted afresh on each collect. Buffers of exited threads
+/// are reused by new threads once collected, so thread pools do not grow memory.
+/// Call only while the instrumented threads are quiescent, e.g. after joining them.
+/// @param profiler Profiler receiving the calls via Jamanak::record().
+/// @param timing Inclusive or self time per call.
+/// @return Number of calls moved.
+size_t collect(Jamanak& profiler, Timing timing = Timing::inclusive);
+
+/// @brief Drops all buffered calls.
+void clear();
+
+} // namespace instrument
+} // namespace jamanak
@@ -0,0 +1,497 @@
+#pragma once
+
+#include "jamanak_analysis.hpp"
+
+#include <array>
+#include <functional>
+
+/// @file jamanak_runner.hpp
+/// @brief Benchmark runners that drive a Jamanak profiler epoch by epoch.
+
+namespace jamanak {
+
+/// @brief Complexity classes fitted by sweep().
+enum Complexity { o_1, o_log_n, o_n, o_n_log_n, o_n2 };
+
+/// @brief Least-squares fit of `time ≈ coefficient · g(n)` for one complexity class.
+struct ComplexityFit {
+    Complexity complexity{Complexity::o_1};                ///< Fitted class.
+    double coefficient{0.0};                               ///< Nanoseconds per unit of g(n).
+    double rms{0.0};                                       ///< RMS of the relative residuals (0.05 = 5%).
+};
+
+/// @brief Timing of a benchmark at one input size.
+struct SweepPoint {
+    size_t n{0};                                           ///< Input size.
+    double mean_ns{0.0};                                   ///< Mean time per run.
+    double stddev_ns{0.0};                                 ///< Sample standard deviation per run.
+};
+
+/// @brief Result of a complexity sweep.
+struct SweepResult {
+    std::string name;                                      ///< Benchmark name.
+    std::vector<SweepPoint> points;                        ///< One entry per size, ascending.
+    std::vector<ComplexityFit> fits;                       ///< Every class, best (lowest RMS) first.
+};
+
+/// @brief Returns the powers of two from @p lo to @p hi (inclusive).
+std::vector<size_t> pow2_sizes(size_t lo = size_t(1) << 10, size_t hi = size_t(1) << 26);
+
+/// @brief Returns a printable name of @p complexity, e.g. "O(n log n)".
+const char* complexity_name(Complexity complexity);
+
+/// @brief Fits `time ≈ c · g(n)` to @p points by least squares on the relative residuals.
+/// @param points Sweep points; at least one.
+/// @param complexity Class providing g(n); logarithms are base 2.
+ComplexityFit fit(const std::vector<SweepPoint>& points, Complexity complexity);
+
+/// @brief Times @p fn over a range of input sizes and fits the results to every complexity class.
+///
+/// Every run is one epoch of @p profiler holding a single jam labelled
+/// "<name> n=<size>" and annotated with `n` items, so the profiler's own reports
+/// (including items/s) cover the sweep as well.
+/// @param profiler Profiler receiving the epochs.
+/// @param name Benchmark name, used in labels and the report.
+/// @param sizes Input sizes, e.g. pow2_sizes().
+/// @param reps Timed runs per size.
+/// @param fn Benchmark body, called with the input size.
+/// @param setup Optional untimed preparation, called once per size before its runs.
+/// @note Each run starts a new epoch, so unsaved jams of @p profiler are discarded.
+/// @throws std::runtime_error if @p sizes is empty or @p reps is zero.
+SweepResult sweep(Jamanak& profiler, const std::string& name, const std::vector<size_t>& sizes, size_t reps,
+                  const std::function<void(size_t)>& fn,
+                  const std::function<void(size_t)>& setup = nullptr);
+
+/// @brief Renders a formatted ANSI report of a sweep: time per size, then every fit, best first.
+/// @param result Result of sweep().
+/// @param unit Unit of the durations; `automatic` picks one from the slowest size.
+std::string to_string(const SweepResult& result, Unit unit = Unit::automatic);
+
+/// @brief Options of scale().
+struct ScalingOptions {
+    size_t max_threads{0};                                 ///< Largest thread count; 0 = hardware concurrency.
+    size_t reps{3};                                        ///< Epochs per thread count.
+    bool pin{false};                                       ///< Pin worker i to CPU i (Linux only).
+};
+
+/// @brief Throughput of one label at one thread count.
+struct ScalingPoint {
+    size_t threads{0};                                     ///< Number of worker threads.
+    double span_ns{0.0};                                   ///< Mean time from the label's first start to its last end.
+    double per_s{0.0};                                     ///< Work per second: items if annotated, else jams.
+    double speedup{0.0};                                   ///< Throughput relative to one thread.
+    double efficiency{0.0};                                ///< Speedup divided by the thread count.
+};
+
+/// @brief Scaling of one label across thread counts.
+struct ScalingLabel {
+    std::string context;                                   ///< Label.
+    bool items{false};                                     ///< Whether throughput counts items (else jams).
+    std::vector<ScalingPoint> points;                      ///< One entry per thread count, ascending.
+    double serial_fraction{0.0};                           ///< Amdahl serial fraction fitted to the speedups.
+};
+
+/// @brief Result of a thread-scaling run.
+struct ScalingResult {
+    std::string name;                                      ///< Benchmark name.
+    std::vector<ScalingLabel> labels;                      ///< Labels in order of first appearance.
+};
+
+/// @brief Fits the Amdahl serial fraction f to 1/S(p) = f + (1 - f)/p by least squares.
+/// @param points Scaling points; those with one thread or no speedup are skipped.
+/// @return f clamped to [0, 1]; 0 if no point has more than one thread.
+double serial_fraction(const std::vector<ScalingPoint>& points);
+
+/// @brief Runs @p workload on 1, 2, 4, ... N threads and measures how each label scales.
+///
+/// Every run is one epoch of @p profiler: a lane is forked per worker, all workers
+/// wait on a shared start barrier, then call @p workload, which records its jams
+/// (optionally annotated with items) on the lane. The Amdahl serial fraction f is
+/// fitted by least squares to 1/S(p) = f + (1 - f)/p.
+/// @param profiler Profiler receiving the epochs.
+/// @param name Benchmark name for the report.
+/// @param workload Called on each worker as workload(lane, worker index, thread count).
+/// @param opts Thread counts, repetitions and pinning.
+/// @note Each run starts a new epoch, so unsaved jams of @p profiler are discarded.
+ScalingResult scale(Jamanak& profiler, const std::string& name,
+                    const std::function<void(Lane&, size_t, size_t)>& workload,
+                    const ScalingOptions& opts = {});
+
+/// @brief Renders a formatted ANSI report of throughput, speedup, efficiency and serial fraction per label.
+std::string to_string(const ScalingResult& result);
+
+/// @brief How cold_warm() makes the caches cold before a cold run.
+enum Eviction {
+    evict_stream,  ///< Stream over a buffer larger than the last-level cache.
+    evict_flush,   ///< `clflush` the given buffers (x86 only; falls back to evict_stream elsewhere).
+};
+
+/// @brief Options of cold_warm().
+struct CacheOptions {
+    size_t reps{10};                                       ///< Cold/warm run pairs.
+    Eviction eviction{Eviction::evict_stream};             ///< Eviction before each cold run.
+    size_t evict_bytes{0};                                 ///< Streamed buffer size; 0 = twice the last-level cache.
+    std::vector<std::pair<const void*, size_t>> flush;     ///< Buffers (address, bytes) flushed by evict_flush.
+};
+
+/// @brief Cold and warm statistics of one label.
+struct CacheLabel {
+    std::string context;                                   ///< Label.
+    LabelStats cold;                                       ///< Runs after an eviction.
+    LabelStats warm;                                       ///< Runs right after a cold run.
+};
+
+/// @brief Result of a cold/warm comparison.
+struct CacheResult {
+    std::string name;                                      ///< Benchmark name.
+    Eviction eviction{Eviction::evict_stream};             ///< Eviction actually used.
+    size_t evict_bytes{0};                                 ///< Streamed buffer size (evict_stream).
+    std::vector<CacheLabel> labels;                        ///< Labels in order of first appearance.
+};
+
+/// @brief Returns the size of the largest data or unified CPU cache in bytes.
+///
+/// Read from /sys/devices/system/cpu/cpu0/cache, falling back to sysconf and then to 32 MiB.
+size_t last_level_cache_bytes();
+
+/// @brief Evicts the caches by reading and writing every line of a buffer of @p bytes.
+/// @param bytes Buffer size; 0 = twice last_level_cache_bytes().
+/// @note The buffer is shared and kept between calls; do not call concurrently.
+void evict_caches(size_t bytes = 0);
+
+/// @brief Flushes every cache line of [@p data, @p data + @p bytes) from all cache levels with `clflush`.
+/// @return Whether flushing is supported on this CPU architecture; nothing happens if not.
+bool flush_caches(const void* data, size_t bytes);
+
+/// @brief Measures every label of @p epoch with cold and with warm caches.
+///
+/// Each repetition evicts the caches (untimed), runs @p epoch once cold and then
+/// once more warm. Cold and warm runs are recorded into separate profilers whose
+/// label statistics are returned side by side.
+/// @param name Benchmark name for the report.
+/// @param epoch Records one epoch's jams on the given profiler (start()/end()).
+/// @param opts Repetitions and eviction method.
+/// @throws std::runtime_error if evict_flush is requested without buffers.
+CacheResult cold_warm(const std::string& name, const std::function<void(Jamanak&)>& epoch,
+                      const CacheOptions& opts = {});
+
+/// @brief Renders a formatted ANSI report of cold and warm mean times and their ratio per label.
+/// @param result Result of cold_warm().
+/// @param unit Unit of the durations; `automatic` picks one from the slowest cold mean.
+std::string to_string(const CacheResult& result, Unit unit = Unit::automatic);
+
+/// @brief A benchmark case of interleave(): a name and the body of one epoch.
+struct Case {
+    std::string name;                                      ///< Case name, also the context of its profiler.
+    std::function<void(Jamanak&)> epoch;                   ///< Records one epoch's jams on the given profiler.
+};
+
+/// @brief Options of interleave().
+struct InterleaveOptions {
+    size_t rounds{20};                                     ///< Recorded rounds; every case runs once per round.
+    size_t warmup{1};                                      ///< Unrecorded rounds before the first recorded one.
+    std::uint64_t seed{42};                                ///< Seed of the per-round shuffle.
+    double confidence{0.95};                               ///< Confidence level of the intervals.
+    bool isolate{false};                                   ///< Run every case in its own forked process.
+    double timeout_s{0.0};                                 ///< Kill an isolated case after this many seconds; 0 = never.
+};
+
+/// @brief Statistics of one case of interleave().
+struct CaseResult {
+    std::string name;                                      ///< Case name.
+    Jamanak profiler{"case"};                              ///< The case's epochs, for label_stats() and reports.
+    std::vector<double> samples;                           ///< Wall time of every recorded epoch in nanoseconds.
+    double mean_ns{0.0};                                   ///< Mean epoch wall time.
+    double ci_ns{0.0};                                     ///< Half-width of the confidence interval of the mean.
+    double delta{0.0};                                     ///< Mean relative to the first case (0.1 = 10% slower).
+    double delta_ci{0.0};                                  ///< Half-width of the confidence interval of delta (Welch).
+    std::string error;                                     ///< Why an isolated case failed (timeout, signal, exit status); empty if it did not.
+};
+
+/// @brief Result of interleave().
+struct InterleaveResult {
+    std::uint64_t seed{0};                                 ///< Seed the order was shuffled with.
+    double confidence{0.95};                               ///< Confidence level of the intervals.
+    bool isolated{false};                                  ///< Whether every case ran in its own process.
+    std::vector<CaseResult> cases;                         ///< Cases in registration order; the first is the baseline.
+};
+
+/// @brief Runs epochs of several cases interleaved in a shuffled order to remove order bias.
+///
+/// Every round runs each case once, in an order drawn with a seeded Fisher-Yates
+/// shuffle (reproducible across platforms). Each case records into its own
+/// profiler, so frequency ramp-up, cache state and drift are spread evenly over
+/// the cases instead of penalising whichever runs first.
+///
+/// With `opts.isolate`, each case instead runs all its rounds in a forked child
+/// process (cases in shuffled order), so allocator state, page cache and lazy
+/// initialisation do not leak between cases. The child streams every epoch back
+/// over a pipe; the parent imports them into the case's profiler. A child that
+/// crashes, exits non-zero or exceeds `opts.timeout_s` is killed if needed and
+/// reported in CaseResult::error, keeping the epochs it completed.
+/// @param cases Cases to compare; the first one is the baseline of the deltas.
+/// @param opts Rounds, warmup, seed and confidence level.
+/// @throws std::runtime_error if @p cases is empty, or if isolation is requested and
+///         fork() or pipe() is unavailable or fails.
+InterleaveResult interleave(const std::vector<Case>& cases, const InterleaveOptions& opts = {});
+
+/// @brief Renders a formatted ANSI comparison table: mean ± CI per case and its delta to the baseline.
+/// @param result Result of interleave().
+/// @param unit Unit of the durations; `automatic` picks one from the slowest case.
+std::string to_string(const InterleaveResult& result, Unit unit = Unit::automatic);
+
+/// @brief Outcome of run_until_steady().
+struct SteadyResult {
+    size_t epochs{0};                                      ///< Epochs run, including warmup.
+    size_t dropped{0};                                     ///< Warmup epochs discarded from the profiler.
+    bool steady{false};                                    ///< Whether steady state plus the sample count was reached.
+};
+
+/// @brief Runs epochs until the steady state is reached and enough steady epochs were recorded.
+///
+/// After every epoch the profiler's history is checked with Jamanak::steady_epoch().
+/// Once a steady window is found and at least @p samples epochs follow its start,
+/// the warmup before it is dropped and the runner stops. If @p max_epochs is hit
+/// first, nothing is dropped and `steady` is false.
+/// @param profiler Profiler receiving the epochs.
+/// @param epoch Records one epoch's jams on the given profiler (start()/end()).
+/// @param samples Steady epochs required, counted from the start of the steady window.
+/// @param max_epochs Upper bound on the number of epochs run.
+/// @param opts Window length and CV threshold of the steady-state test.
+SteadyResult run_until_steady(Jamanak& profiler, const std::function<void(Jamanak&)>& epoch, size_t samples,
+                              size_t max_epochs = 1000, const SteadyOptions& opts = {});
+
+/// @brief Log-linear latency histogram with fixed storage (HdrHistogram-style, ~1% precision).
+///
+/// Values below 128 ns get exact buckets; above, every power of two is split into
+/// 64 buckets. All storage is allocated by the constructor, so record() never
+/// allocates and can be used inside latency-critical loops.
+class LatencyHistogram {
+public:
+    LatencyHistogram() : counts(buckets, 0) {}
+
+    /// @brief Adds one value in nanoseconds; negative values count as zero.
+    void record(std::int64_t ns) {
+        const std::uint64_t v = ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+        ++counts[index(v)];
+        ++n;
+        sum += static_cast<double>(v);
+        top = std::max(top, v);
+    }
+
+    /// @brief Adds all values of @p o.
+    void merge(const LatencyHistogram& o) {
+        for (size_t i = 0; i < buckets; ++i) counts[i] += o.counts[i];
+        n += o.n;
+        sum += o.sum;
+        top = std::max(top, o.top);
+    }
+
+    /// @brief Returns the number of recorded values.
+    std::uint64_t count() const { return n; }
+
+    /// @brief Returns the mean in nanoseconds.
+    double mean() const { return n ? sum / static_cast<double>(n) : 0.0; }
+
+    /// @brief Returns the largest recorded value in nanoseconds.
+    double max() const { return static_cast<double>(top); }
+
+    /// @brief Returns the @p q quantile (0..1) in nanoseconds, as the midpoint of its bucket.
+    double quantile(double q) const;
+
+    /// @brief Returns the number of recorded values above @p ns.
+    std::uint64_t count_above(std::int64_t ns) const;
+
+private:
+    static constexpr size_t sub = 128;                    ///< Exact buckets; also the bucket count per power of two above.
+    static constexpr size_t buckets = sub + 56 * (sub / 2); ///< Covers every non-negative int64.
+
+    /// @brief Returns the bucket of @p v.
+    static size_t index(std::uint64_t v) {
+        if (v < sub) return static_cast<size_t>(v);
+        size_t msb = 63;
+        while (!(v >> msb)) --msb;
+        const size_t shift = msb - 6;
+        return sub + (shift - 1) * (sub / 2) + static_cast<size_t>((v >> shift) - sub / 2);
+    }
+
+    /// @brief Returns the smallest value of bucket @p i.
+    static std::uint64_t lower(size_t i) {
+        if (i < sub) return i;
+        const size_t k = i - sub, shift = k / (sub / 2) + 1;
+        return static_cast<std::uint64_t>(k % (sub / 2) + sub / 2) << shift;
+    }
+
+    std::vector<std::uint64_t> counts;                     ///< Values per bucket.
+    std::uint64_t n{0};                                    ///< Number of values.
+    double sum{0.0};                                       ///< Sum of values.
+    std::uint64_t top{0};                                  ///< Largest value.
+};
+
+/// @brief Options of load().
+struct LoadOptions {
+    double rate{1000.0};                                   ///< Target calls per second, summed over all threads.
+    double duration_s{5.0};                                ///< Length of the schedule.
+    size_t threads{1};                                     ///< Threads issuing calls; call k runs on thread k % threads.
+};
+
+/// @brief Latency distribution of one label under load.
+struct LoadLabel {
+    std::string context;                                   ///< Label.
+    LatencyHistogram latency;                              ///< Durations; for the request label measured from the intended start.
+};
+
+/// @brief Result of load().
+struct LoadResult {
+    std::string name;                                      ///< Request label.
+    double target_rate{0.0};                               ///< Requested calls per second.
+    double achieved_rate{0.0};                             ///< Completed calls per second over the run.
+    std::uint64_t calls{0};                                ///< Completed calls.
+    std::uint64_t late{0};                                 ///< Calls that started after their intended start.
+    LatencyHistogram service;                              ///< Request time from the actual start (what closed-loop timing sees).
+    std::vector<LoadLabel> labels;                         ///< The request label first, then the labels recorded inside calls.
+};
+
+/// @brief Drives @p fn open-loop on a fixed-rate schedule and records coordinated-omission-corrected latency.
+///
+/// Call k is due at start + k / rate, regardless of how long earlier calls took.
+/// Its latency is recorded under @p name from the due time, not from when it
+/// actually began, so queueing behind a slow call shows up in the tail instead of
+/// being omitted. Jams @p fn records on its profiler are collected per label: each
+/// worker folds them into histograms every few thousand jams, preferably while it
+/// waits for the next due time, and clears its profiler's current epoch. Memory
+/// therefore does not grow with rate × duration.
+/// @param name Label of the whole request.
+/// @param fn Request handler; called with the issuing thread's profiler and the call index.
+/// @param opts Rate, duration and thread count.
+/// @throws std::runtime_error if the rate, duration or thread count is not positive.
+LoadResult load(const std::string& name, const std::function<void(Jamanak&, std::uint64_t)>& fn,
+                const LoadOptions& opts = {});
+
+/// @brief Renders a formatted ANSI report of achieved vs target throughput and p50–p99.99 per label.
+/// @param result Result of load().
+/// @param unit Unit of the latencies; `automatic` picks one from the largest p99.99.
+std::string to_string(const LoadResult& result, Unit unit = Unit::automatic);
+
+/// @brief Options of periodic().
+struct PeriodicOptions {
+    double period_us{1000.0};                              ///< Cycle period.
+    size_t cycles{10000};                                  ///< Number of cycles.
+    double deadline_us{0.0};                               ///< Work must end this long after the scheduled wakeup; 0 = one period.
+};
+
+/// @brief Result of periodic().
+struct PeriodicResult {
+    std::string name;                                      ///< Loop name.
+    double period_ns{0.0};                                 ///< Cycle period.
+    double deadline_ns{0.0};                               ///< Deadline relative to the scheduled wakeup.
+    size_t cycles{0};                                      ///< Cycles run.
+    size_t misses{0};                                      ///< Cycles whose work ended after the deadline.
+    double max_lateness_ns{0.0};                           ///< Largest (work end - deadline); negative if every cycle made it.
+    LatencyHistogram wakeup;                               ///< Actual minus scheduled wakeup time.
+    LatencyHistogram work;                                 ///< Work time per cycle.
+};
+
+/// @brief Runs @p work once per period, cyclictest-style, and measures wakeup jitter and deadline misses.
+///
+/// Cycle k is scheduled at start + k · period on the monotonic clock and waited
+/// for with an absolute `clock_nanosleep` (sleep_until outside Linux), so
+/// lateness never accumulates.
+/// Each cycle records two jams on @p profiler: "<name> wakeup" from the scheduled
+/// to the actual wakeup, and "<name>" for the work, both timed on the monotonic
+/// clock. All cycles form one epoch, which is ended when the loop finishes.
+/// Storage for the jams and histograms is reserved and both labels are interned
+/// up front, so the loop itself neither allocates nor hashes.
+/// @param profiler Profiler receiving the jams.
+/// @param name Loop name, used for the labels.
+/// @param work Body of one cycle.
+/// @param opts Period, cycle count and deadline.
+/// @throws std::runtime_error if the period is not positive or @p profiler is jamming.
+/// @note The loop starts a new epoch, so unsaved jams of @p profiler are discarded;
+///       call end_epoch() first to keep them.
+PeriodicResult periodic(Jamanak& profiler, const std::string& name, const std::function<void()>& work,
+                        const PeriodicOptions& opts = {});
+
+/// @brief Renders a formatted ANSI report of wakeup latency and work time, a jitter histogram and deadline misses.
+/// @param unit Unit of all durations; `automatic` picks one from the p99.9 wakeup and work times.
+std::string to_string(const PeriodicResult& result, Unit unit = Unit::automatic);
+
+/// @brief Time a label took in frames that went over budget.
+struct FrameStage {
+    std::string context;                                   ///< Label.
+    double over_ns{0.0};                                   ///< Summed time in over-budget frames.
+    size_t frames{0};                                      ///< Over-budget frames the label appeared in.
+};
+
+/// @brief Frame-budget tracking on top of a profiler's epochs, for render and game loops.
+///
+/// Each frame is one epoch. Frame times, measured on the monotonic clock, go into
+/// a LatencyHistogram. For frames over budget, the time per label is read straight
+/// from the epoch's packed jams and added to the per-stage totals, and the slowest
+/// frames keep their breakdown. The most recent frames stay in the profiler as
+/// epochs, so its reports and timelines cover them; older ones are dropped in
+/// batches, so memory stays bounded in an endless loop. hud() formats a one-line
+/// summary into a fixed buffer, cheap enough to draw every frame.
+class FrameBudget {
+public:
+    /// @brief Tracks frames of @p profiler against @p budget_ms (e.g. 16.6 or 8.3).
+    ///
+    /// The profiler keeps between @p keep_frames and twice that many completed frames
+    /// as epochs; once it holds twice as many, the oldest are dropped with drop_epochs().
+    /// @throws std::runtime_error if the budget is not positive or @p keep_frames is 0.
+    FrameBudget(Jamanak& profiler, double budget_ms = 16.6, size_t keep_frames = 120);
+
+    /// @brief Starts a frame (begins an epoch).
+    void begin_frame();
+
+    /// @brief Ends the frame (ends the epoch) and accounts for it.
+    /// @return Frame time in nanoseconds.
+    double end_frame();
+
+    /// @brief Returns a one-line summary: last frame, p50/p99, overruns and fps.
+    ///
+    /// Written into an internal buffer with snprintf; valid until the next call.
+    /// The percentiles are refreshed every hud_every frames rather than on each call.
+    const char* hud();
+
+    /// @brief Returns the distribution of frame times.
+    const LatencyHistogram& frame_times() const { return times; }
+
+    /// @brief Returns the number of frames over budget.
+    size_t overruns() const { return over; }
+
+    /// @brief Returns the per-label time in over-budget frames, largest first.
+    std::vector<FrameStage> over_budget_stages() const;
+
+    /// @brief Renders a formatted ANSI report: frame time percentiles, overruns, stage shares and worst frames.
+    std::string to_string() const;
+
+private:
+    /// @brief Breakdown of one over-budget frame.
+    struct OverBudgetFrame {
+        size_t frame{0};                                   ///< Frame index, counted from the first begin_frame().
+        double frame_ns{0.0};                              ///< Frame time.
+        std::vector<std::pair<std::uint32_t, double>> stages; ///< Time per interned label, largest first.
+    };
+
+    Jamanak& profiler;                                     ///< Profiler the frames are recorded into.
+    double budget_ns;                                      ///< Frame budget.
+    LatencyHistogram times;                                ///< Frame times.
+    size_t frames{0};                                      ///< Frames ended.
+    size_t over{0};                                        ///< Frames over budget.
+    double last_ns{0.0};                                   ///< Last frame time.
+    std::chrono::steady_clock::time_point frame_t0{};      ///< Start of the current frame.
+    std::vector<double> over_ns;                           ///< Per label id: summed time in over-budget frames.
+    std::vector<size_t> over_frames;                       ///< Per label id: over-budget frames it appeared in.
+    std::vector<size_t> slot;                              ///< Per label id: 1 + its index in scratch.stages, 0 if absent.
+    OverBudgetFrame scratch;                               ///< Breakdown of the frame being accounted.
+    std::vector<OverBudgetFrame> worst;                    ///< Slowest over-budget frames, slowest first.
+    size_t keep;                                           ///< Completed frames kept as epochs (up to twice as many).
+    static constexpr size_t hud_every = 30;                ///< Frames between refreshes of the hud() percentiles.
+    size_t hud_frames{0};                                  ///< Frame count at the last refresh.
+    double hud_p50{0.0};                                   ///< Cached p50 frame time.
+    double hud_p99{0.0};                                   ///< Cached p99 frame time.
+    std::array<char, 160> line{};                          ///< hud() buffer.
+};
+
+} // namespace jamanak
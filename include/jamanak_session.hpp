@@ -0,0 +1,61 @@
+#pragma once
+
+#include "jamanak_analysis.hpp"
+
+/// @file jamanak_session.hpp
+/// @brief Benchmark sessions that stabilize and record the machine state.
+///
+/// Migrations, frequency scaling, SMT siblings and background load are the main
+/// sources of run-to-run noise. A Session pins the measuring thread, optionally
+/// raises its priority, probes cpufreq/turbo/load from sysfs and procfs, and warns
+/// about conditions that make results noisy. Attach it to a profiler to print the
+/// environment below its reports and include it in to_json().
+
+namespace jamanak {
+
+/// @brief Options of a Session.
+struct SessionOptions {
+    int cpu{-1};                                           ///< CPU to pin to; -1 = the CPU the thread runs on.
+    bool pin{true};                                        ///< Pin the calling thread with sched_setaffinity.
+    bool raise_priority{false};                            ///< Lower the thread's nice value to -20 (needs CAP_SYS_NICE).
+    bool warn{true};                                       ///< Print the environment warnings to stderr on construction.
+    double max_load{1.0};                                  ///< Warn if the 1-minute load average exceeds this.
+};
+
+/// @brief Probes the machine state as seen from @p cpu, without changing it.
+/// @param cpu CPU whose governor and SMT siblings are read; -1 = the CPU the thread runs on.
+/// @param max_load Warn if the 1-minute load average exceeds this.
+/// @return Environment with `cpu` left at -1 (not pinned) and the warnings filled in.
+Environment probe_environment(int cpu = -1, double max_load = 1.0);
+
+/// @brief Scoped benchmark session: pins and prioritizes the calling thread until destroyed.
+///
+/// Construct it on the measuring thread before the timed loop. The destructor
+/// restores the previous CPU affinity and nice value. Outside Linux the session
+/// only records what it can and never pins.
+class Session {
+public:
+    /// @brief Applies @p opts to the calling thread and probes the environment.
+    explicit Session(const SessionOptions& opts = {});
+
+    /// @brief Restores the calling thread's affinity and priority.
+    ~Session();
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    /// @brief Returns the probed environment, including the effect of pinning and priority.
+    const Environment& environment() const { return env; }
+
+    /// @brief Records the environment with @p profiler's results.
+    void attach(Jamanak& profiler) const { profiler.set_environment(env); }
+
+private:
+    Environment env;                                       ///< Probed environment.
+    bool restore_affinity{false};                          ///< Whether old_affinity holds a mask to restore.
+    bool restore_nice{false};                              ///< Whether old_nice must be restored.
+    int old_nice{0};                                       ///< Nice value before the session.
+    std::vector<unsigned char> old_affinity;               ///< CPU mask before the session (cpu_set_t bytes).
+};
+
+} // namespace jamanak
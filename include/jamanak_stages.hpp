@@ -0,0 +1,235 @@
+#pragma once
+
+#include "jamanak_analysis.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// @file jamanak_stages.hpp
+/// @brief Enum-indexed profiler for a fixed set of stages known at compile time.
+
+namespace jamanak {
+
+/// @brief Running moments of one stage's durations (Welford), as kept by StageJamanak.
+struct StageMoments {
+    std::uint64_t count{0};                            ///< Number of calls.
+    double mean{0.0};                                  ///< Mean duration in nanoseconds.
+    double m2{0.0};                                    ///< Sum of squared deviations.
+    double sum{0.0};                                   ///< Summed duration in nanoseconds.
+    double min{0.0};                                   ///< Shortest call.
+    double max{0.0};                                   ///< Longest call.
+
+    /// @brief Adds one duration.
+    void add(double x) {
+        min = count ? std::min(min, x) : x;
+        max = count ? std::max(max, x) : x;
+        ++count;
+        const double d = x - mean;
+        mean += d / static_cast<double>(count);
+        m2   += d * (x - mean);
+        sum  += x;
+    }
+
+    /// @brief Folds @p o into these moments (Chan et al.).
+    void merge(const StageMoments& o) {
+        if (!o.count) return;
+        if (!count) { *this = o; return; }
+        const double n = static_cast<double>(count + o.count);
+        const double d = o.mean - mean;
+        m2   += o.m2 + d * d * static_cast<double>(count) * static_cast<double>(o.count) / n;
+        mean += d * static_cast<double>(o.count) / n;
+        sum  += o.sum;
+        min   = std::min(min, o.min);
+        max   = std::max(max, o.max);
+        count += o.count;
+    }
+};
+
+/// @brief Profiler for a fixed set of stages known at compile time.
+///
+/// Stages are the enumerators 0..N-1 of @p Stage, and per-stage statistics live in
+/// std::arrays indexed by them: recording does no string handling, hashing or
+/// allocation. Only running moments are kept, so the p50/p95/p99 columns and the
+/// histogram/trend cells are not available in the report.
+/// @tparam Stage Enum whose enumerators index the stages.
+/// @tparam N Number of stages; defaults to `Stage::count`.
+template <typename Stage, size_t N = static_cast<size_t>(Stage::count)>
+class StageJamanak {
+public:
+    using Names = std::array<const char*, N>;             ///< Stage names, indexed by enumerator.
+
+private:
+    const char* global_context;              ///< Label shown in the report header.
+    Names names;                             ///< Stage names.
+    std::array<StageMoments, N> totals{};         ///< Per-stage moments over completed epochs.
+    std::array<StageMoments, N> pending{};        ///< Per-stage moments of the current epoch.
+    size_t epoch_count_{0};                  ///< Completed epochs.
+    double wall_sum{0.0};                    ///< Summed epoch wall time in nanoseconds.
+    double untracked_sum{0.0};               ///< Summed untracked time in nanoseconds.
+    Clock::time_point epoch_t0{};            ///< Wall-clock start of the current epoch.
+    bool epoch_open{false};                  ///< Whether epoch_t0 is set; else the first stage starts the epoch.
+    bool epoch_started{false};               ///< Whether the current epoch has recorded a stage.
+    size_t current_stage{0};                 ///< Index of the active stage.
+    Clock::time_point current_t0{};          ///< Start of the active stage.
+    State jam_state{State::idle};            ///< Whether a measurement is in progress.
+
+    /// @brief Clears the current epoch.
+    void reset_pending() {
+        pending.fill(StageMoments{});
+        epoch_started = false;
+    }
+
+    /// @brief Returns the array index of @p stage.
+    /// @throws std::runtime_error if @p stage is not one of the N stages.
+    static size_t index(Stage stage) {
+        const auto i = static_cast<size_t>(stage);
+        if (i >= N) throw std::runtime_error("stage out of range");
+        return i;
+    }
+
+public:
+    /// @brief Constructs a stage profiler.
+    /// @param names Stage names, indexed by enumerator; must outlive the profiler.
+    /// @param context Report title; must outlive the profiler.
+    explicit StageJamanak(const Names& names, const char* context = "default")
+        : global_context(context), names(names) {}
+
+    /// @brief Starts measuring @p stage.
+    /// @throws std::runtime_error if a stage is already active or @p stage is out of range.
+    void start(Stage stage) {
+        if (jam_state == State::jamming) throw std::runtime_error("already jamming");
+
+        current_stage = index(stage);
+        jam_state = State::jamming;
+        current_t0 = Clock::now();
+        if (!epoch_open && !epoch_started) epoch_t0 = current_t0;
+        epoch_started = true;
+    }
+
+    /// @brief Stops the active stage and records it.
+    /// @return The measured duration in nanoseconds.
+    /// @throws std::runtime_error if no stage is active.
+    std::int64_t end() {
+        auto t1 = Clock::now();
+        if (jam_state == State::idle) throw std::runtime_error("jamming not started");
+
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - current_t0).count();
+        pending[current_stage].add(static_cast<double>(ns));
+        jam_state = State::idle;
+        return ns;
+    }
+
+    /// @brief Adds an already measured stage to the current epoch.
+    ///
+    /// As in Jamanak::record(), for work timed elsewhere; an active stage is not affected.
+    /// @param stage Stage to file the time under.
+    /// @param t0 Start time.
+    /// @param t1 End time.
+    /// @return The duration in nanoseconds.
+    /// @throws std::runtime_error if @p stage is out of range.
+    std::int64_t record(Stage stage, Clock::time_point t0, Clock::time_point t1) {
+        const size_t i = index(stage);
+        if (!epoch_open && (!epoch_started || t0 < epoch_t0)) epoch_t0 = t0;
+        epoch_started = true;
+
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        pending[i].add(static_cast<double>(ns));
+        return ns;
+    }
+
+    /// @brief Starts a new epoch; its wall time is measured from now.
+    /// @throws std::runtime_error if a stage is active.
+    void begin_epoch() {
+        if (jam_state == State::jamming) throw std::runtime_error("cannot begin epoch while jamming");
+        reset_pending();
+        epoch_t0 = Clock::now();
+        epoch_open = true;
+    }
+
+    /// @brief Folds the current epoch into the totals and starts the next one.
+    ///
+    /// As in Jamanak::end_epoch(), the epoch's wall time runs from begin_epoch()
+    /// (or the end of the previous epoch, or else the first stage) until now; the
+    /// next epoch starts right away.
+    /// @throws std::runtime_error if a stage is active.
+    void end_epoch() {
+        if (jam_state == State::jamming) throw std::runtime_error("cannot end epoch while jamming");
+
+        auto now = Clock::now();
+        if (epoch_started) {
+            const double wall = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - epoch_t0).count());
+            double covered = 0.0;
+            for (size_t i = 0; i < N; ++i) {
+                covered += pending[i].sum;
+                totals[i].merge(pending[i]);
+            }
+            wall_sum      += wall;
+            untracked_sum += std::max(0.0, wall - covered);
+            ++epoch_count_;
+        }
+
+        reset_pending();
+        epoch_t0 = now;
+        epoch_open = true;
+    }
+
+    /// @brief Discards the current epoch.
+    /// @throws std::runtime_error if a stage is active.
+    void cancel_epoch() {
+        if (jam_state == State::jamming) throw std::runtime_error("cannot cancel epoch while jamming");
+        reset_pending();
+        epoch_t0 = Clock::now();
+        epoch_open = true;
+    }
+
+    /// @brief Discards all epochs.
+    void clean_epochs() {
+        totals.fill(StageMoments{});
+        reset_pending();
+        epoch_count_ = 0;
+        wall_sum = untracked_sum = 0.0;
+        epoch_open = false;
+    }
+
+    /// @brief Returns the number of completed epochs.
+    size_t epoch_count() const { return epoch_count_; }
+
+    /// @brief Returns the mean wall time per epoch in nanoseconds; 0 if there are no epochs.
+    double epoch_wall_ns() const { return epoch_count_ ? wall_sum / static_cast<double>(epoch_count_) : 0.0; }
+
+    /// @brief Returns the mean untracked time per epoch in nanoseconds; 0 if there are no epochs.
+    double epoch_untracked_ns() const { return epoch_count_ ? untracked_sum / static_cast<double>(epoch_count_) : 0.0; }
+
+    /// @brief Returns the mean time per epoch spent in @p stage, in nanoseconds.
+    /// @throws std::runtime_error if @p stage is out of range.
+    double epoch_ns(Stage stage) const {
+        const size_t i = index(stage);
+        return epoch_count_ ? totals[i].sum / static_cast<double>(epoch_count_) : 0.0;
+    }
+
+    /// @brief Returns whether a stage is active.
+    bool is_jamming() const { return jam_state == State::jamming; }
+
+    /// @brief Returns per-stage statistics over all epochs, in enumerator order.
+    ///
+    /// Stages that never ran are skipped. Percentile fields are left at zero.
+    std::vector<LabelStats> label_stats() const {
+        return Jamanak::stage_stats(names.data(), totals.data(), N, epoch_count_);
+    }
+
+    /// @brief Renders the per-stage epoch report in the same layout as Jamanak::to_string_epochs().
+    /// @param opts Unit, columns and noise highlighting; percentile columns and shapes are ignored.
+    /// @return Multi-line string; empty string if no epochs.
+    std::string to_string_epochs(const ReportOptions& opts = {}) const {
+        return Jamanak::render_stages(global_context, names.data(), totals.data(), N, epoch_count_,
+                                      epoch_wall_ns(), epoch_untracked_ns(), opts);
+    }
+};
+
+} // namespace jamanak
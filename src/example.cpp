@@ -1,5 +1,7 @@
 #include "jamanak.hpp"
 
+#include <thread>
+
 int main () {
 
     jamanak::Jamanak durs = jamanak::Jamanak("Counting Durations");
@@ -22,8 +24,43 @@ int main () {
     std::puts("");
 
     for (const auto& j : durs.get_jams()) {
-        std::printf("%s: %.6f ms\n", j->context.c_str(), j->duration_ms);
+        std::printf("%s: %.6f ms\n", j.context.c_str(), j.duration_ms);
     }
 
+    std::puts("");
+
+    jamanak::Jamanak pipeline("Fork/Join");
+
+    for (size_t epoch = 0; epoch < 5; epoch++) {
+        pipeline.begin_epoch();
+
+        pipeline.start("split");
+        for (size_t i = 0; i < 1000000; i++){}
+        pipeline.end();
+
+        std::vector<jamanak::Lane> lanes;
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < 3; t++) lanes.push_back(pipeline.fork());
+        for (size_t t = 0; t < 3; t++) {
+            workers.emplace_back([&lanes, t] {
+                lanes[t].start("work " + std::to_string(t));
+                for (size_t i = 0; i < 10000000 * (t + 1); i++){}
+                lanes[t].end();
+            });
+        }
+        for (auto& w : workers) w.join();
+        for (auto& l : lanes) pipeline.join(l);
+
+        pipeline.start("merge");
+        for (size_t i = 0; i < 1000000; i++){}
+        pipeline.end();
+
+        pipeline.end_epoch();
+    }
+
+    std::printf("%s",pipeline.to_string_epochs().c_str());
+    std::printf("%s",pipeline.to_string_critical_path().c_str());
+    std::printf("%s",pipeline.to_timeline_epoch(pipeline.epoch_count() - 1).c_str());
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "jamanak_instrument.hpp"
+
+#include <cstdio>
+#include <thread>
+
+// Built with -finstrument-functions: none of these functions mention jamanak.
+
+volatile double sink;
+
+void parse(size_t n) {
+    double acc = 0;
+    for (size_t i = 0; i < n; i++) acc += static_cast<double>(i) * 0.5;
+    sink = acc;
+}
+
+void transform(size_t n) {
+    for (int pass = 0; pass < 4; pass++) parse(n / 4);
+    double acc = 0;
+    for (size_t i = 0; i < n; i++) acc += static_cast<double>(i % 7);
+    sink = acc;
+}
+
+void frame() {
+    parse(200000);
+    transform(800000);
+}
+
+int main () {
+
+    jamanak::Jamanak calls("Instrumented");
+
+    for (int epoch = 0; epoch < 5; epoch++) {
+        calls.begin_epoch();
+
+        std::thread worker([] { transform(400000); });
+        frame();
+        worker.join();
+
+        jamanak::instrument::collect(calls, jamanak::instrument::self);
+        calls.end_epoch();
+    }
+
+    std::printf("%s", calls.to_string_epochs().c_str());
+    std::printf("%s", calls.to_timeline_epoch(calls.epoch_count() - 1).c_str());
+
+    return 0;
+}
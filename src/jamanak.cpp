@@ -1 +1,1553 @@
-#include "jamanak.hpp"
\ No newline at end of file
+/// @file jamanak.cpp
+/// @brief Statistics, critical path analysis and report rendering of the jamanak library.
+
+#include "jamanak.hpp"
+#include "jamanak_analysis.hpp"
+#include "jamanak_format.hpp"
+#include "jamanak_stages.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <set>
+#include <thread>
+#include <tuple>
+
+namespace jamanak {
+
+using namespace format_detail;
+
+namespace {
+
+/// @brief xoshiro256+ generator: a few cycles per draw, ample quality for resampling.
+struct Xoshiro {
+    std::uint64_t s[4];                                    ///< Generator state.
+
+    /// @brief Seeds the state from @p seed with splitmix64.
+    explicit Xoshiro(std::uint64_t seed) {
+        for (auto& w : s) {
+            std::uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            w = z ^ (z >> 31);
+        }
+    }
+
+    /// @brief Returns the next 64 random bits.
+    std::uint64_t next() {
+        const std::uint64_t out = s[0] + s[3];
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = (s[3] << 45) | (s[3] >> 19);
+        return out;
+    }
+
+    /// @brief Returns a random index below @p n (multiply-shift; exact for n < 2^32).
+    size_t below(size_t n) {
+        return n >> 32 ? static_cast<size_t>(next() % n) : static_cast<size_t>(((next() >> 32) * n) >> 32);
+    }
+};
+
+/// @brief Renders @p values as a row of Unicode block characters scaled to [lo, hi].
+/// @param zero_blank Render zero values as blanks instead of the lowest block.
+std::string blocks(const std::vector<double>& values, double lo, double hi, bool zero_blank) {
+    static const char* levels[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+    std::string out;
+    for (double v : values) {
+        if (zero_blank && v <= 0.0) { out += " "; continue; }
+        double t = hi > lo ? (v - lo) / (hi - lo) : 1.0;
+        out += levels[std::min<size_t>(7, static_cast<size_t>(std::max(0.0, t) * 7.0 + 0.5))];
+    }
+    return out;
+}
+
+/// @brief Renders the duration histogram of sorted @p calls with @p bins characters.
+std::string histogram(const std::vector<double>& calls, size_t bins) {
+    if (calls.empty() || bins == 0) return std::string(bins, ' ');
+    const double lo = calls.front(), hi = calls.back();
+    std::vector<double> counts(bins, 0.0);
+    for (double x : calls) {
+        size_t b = hi > lo ? static_cast<size_t>((x - lo) / (hi - lo) * static_cast<double>(bins)) : 0;
+        counts[std::min(b, bins - 1)] += 1.0;
+    }
+    return blocks(counts, 0.0, *std::max_element(counts.begin(), counts.end()), true);
+}
+
+/// @brief Renders a sparkline of @p series, averaging neighbouring epochs down to @p width characters.
+std::string sparkline(const std::vector<double>& series, size_t width, size_t& chars) {
+    std::vector<double> points;
+    const size_t n = series.size();
+    const size_t w = std::min(n, std::max<size_t>(width, 1));
+    for (size_t b = 0; b < w; ++b) {
+        size_t from = b * n / w, to = (b + 1) * n / w;
+        double sum = 0.0;
+        for (size_t i = from; i < to; ++i) sum += series[i];
+        points.push_back(sum / static_cast<double>(to - from));
+    }
+    chars = points.size();
+    if (points.empty()) return "";
+    auto mm = std::minmax_element(points.begin(), points.end());
+    return blocks(points, *mm.first, *mm.second, false);
+}
+
+/// @brief Converts running moments of one label to its statistics; percentiles are left at zero.
+LabelStats from_moments(const std::string& context, const StageMoments& m, size_t n_epochs) {
+    LabelStats st;
+    st.context     = context;
+    st.count       = m.count;
+    st.mean_ns     = m.mean;
+    st.epoch_ns    = m.sum / static_cast<double>(n_epochs);
+    st.min_ns      = m.min;
+    st.max_ns      = m.max;
+    st.stddev_ns   = m.count > 1 ? std::sqrt(m.m2 / static_cast<double>(m.count - 1)) : 0.0;
+    st.cv          = m.mean > 0.0 ? st.stddev_ns / m.mean : 0.0;
+    st.calls_per_s = m.sum > 0.0 ? static_cast<double>(m.count) / m.sum * 1e9 : 0.0;
+    return st;
+}
+
+/// @brief Renders @p env as a framed block of "key: value" lines followed by its warnings.
+std::string render_environment(const Environment& env) {
+    if (!env.probed) return "";
+
+    std::ostringstream state;
+    state << std::fixed << std::setprecision(2);
+    if (env.cpu >= 0) state << "cpu " << env.cpu << " pinned";
+    else state << "unpinned";
+    if (!env.siblings.empty()) state << " (smt " << env.siblings << ")";
+    state << " · governor " << (env.governor.empty() ? "?" : env.governor);
+    state << " · turbo " << (env.turbo < 0 ? "?" : env.turbo ? "on" : "off");
+    state << " · load " << env.load[0];
+    state << " · nice " << env.nice;
+
+    std::vector<std::pair<std::string, std::string>> lines;
+    lines.emplace_back("host", env.host + (env.cpu_model.empty() ? "" : " · " + env.cpu_model) +
+                               " · " + std::to_string(env.cpus) + " cpus");
+    lines.emplace_back("env", state.str());
+
+    size_t width = 0;
+    for (const auto& l : lines) width = std::max(width, text_width(l.second));
+    for (const auto& w : env.warnings) width = std::max(width, text_width(w));
+    const size_t l_size = width + 16;
+
+    std::ostringstream out;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << fence(l_size, "–") << "\n";
+    for (const auto& l : lines) {
+        out << "|| " << l.first << " " << fence(7 - text_width(l.first), "─") << ": " << ANSI_RESET;
+        out << ANSI_RGB(143,227,125) << l.second << ANSI_RESET;
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << fence(width - text_width(l.second), " ") << " ||\n";
+    }
+    for (const auto& w : env.warnings) {
+        out << "|| warning : " << ANSI_RESET;
+        out << ANSI_BOLD << ANSI_RGB(227,143,125) << w << ANSI_RESET;
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << fence(width - text_width(w), " ") << " ||\n";
+    }
+    out << fence(l_size, "–") << ANSI_RESET << "\n";
+    return out.str();
+}
+
+/// @brief Renders a framed warning about @p n jams clamped to the PackedJam limits; empty if none.
+std::string render_saturated(size_t n) {
+    if (!n) return "";
+
+    const std::string w = std::to_string(n) + (n == 1 ? " jam" : " jams") +
+                          " clamped to the packed limits (duration < 18.3 min, start < 78.2 h)";
+    const size_t l_size = text_width(w) + 16;
+
+    std::ostringstream out;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << fence(l_size, "–") << "\n";
+    out << "|| warning : " << ANSI_RESET;
+    out << ANSI_BOLD << ANSI_RGB(227,143,125) << w << ANSI_RESET;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||\n";
+    out << fence(l_size, "–") << ANSI_RESET << "\n";
+    return out.str();
+}
+
+/// @brief Segments @p x into runs of constant mean with PELT and returns the start of every run but the first.
+/// @param x Series to segment.
+/// @param beta Penalty per change point, in the units of the squared-error cost.
+/// @param min_seg Fewest points per run.
+std::vector<size_t> pelt(const std::vector<double>& x, double beta, size_t min_seg) {
+    const size_t n = x.size();
+    std::vector<double> s1(n + 1, 0.0), s2(n + 1, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        s1[i + 1] = s1[i] + x[i];
+        s2[i + 1] = s2[i] + x[i] * x[i];
+    }
+    auto cost = [&](size_t a, size_t b) {
+        const double d = s1[b] - s1[a];
+        return s2[b] - s2[a] - d * d / static_cast<double>(b - a);
+    };
+
+    std::vector<double> f(n + 1, 0.0);
+    std::vector<size_t> last(n + 1, 0);
+    std::vector<size_t> cands{0};
+    f[0] = -beta;
+    for (size_t t = min_seg; t <= n; ++t) {
+        if (t >= 2 * min_seg) cands.push_back(t - min_seg);
+
+        double best = std::numeric_limits<double>::infinity();
+        size_t arg = 0;
+        std::vector<double> vals(cands.size());
+        for (size_t c = 0; c < cands.size(); ++c) {
+            vals[c] = f[cands[c]] + cost(cands[c], t);
+            if (vals[c] + beta < best) { best = vals[c] + beta; arg = cands[c]; }
+        }
+        f[t] = best;
+        last[t] = arg;
+
+        // Candidates that cannot start the last run of any later optimum are pruned.
+        size_t k = 0;
+        for (size_t c = 0; c < cands.size(); ++c) {
+            if (vals[c] <= best) cands[k++] = cands[c];
+        }
+        cands.resize(k);
+    }
+
+    std::vector<size_t> out;
+    for (size_t t = last[n]; t > 0; t = last[t]) out.push_back(t);
+    std::reverse(out.begin(), out.end());
+    return out;
+}
+
+/// @brief Renders the stability section of the epoch report for @p labels.
+std::string render_stability(const std::vector<LabelStability>& labels, Unit unit) {
+    std::vector<std::pair<std::string, std::string>> lines;
+    size_t l_ctx = 0;
+    for (const auto& l : labels) {
+        std::string ctx = l.context;
+        for (const auto& c : l.changes) {
+            std::ostringstream ss;
+            ss << std::fixed << std::setprecision(1);
+            ss << "change at epoch " << c.epoch << ": " << format(c.before_ns, unit) << " → "
+               << format(c.after_ns, unit) << " " << unit_suffix(unit) << " ("
+               << std::showpos << (c.before_ns > 0.0 ? (c.after_ns / c.before_ns - 1.0) * 100.0 : 0.0)
+               << std::noshowpos << "%)";
+            lines.emplace_back(ctx, ss.str());
+            ctx.clear();
+        }
+        if (l.drifting) {
+            std::ostringstream ss;
+            ss << "drift " << format(l.slope_ns * 100.0, unit) << " " << unit_suffix(unit) << " per 100 epochs"
+               << std::fixed << std::setprecision(1) << " (t = " << l.slope_t << ")";
+            lines.emplace_back(ctx, ss.str());
+        }
+        if (!l.changes.empty() || l.drifting) l_ctx = std::max(l_ctx, text_width(l.context));
+    }
+    if (lines.empty()) lines.emplace_back("", "all labels stable");
+
+    size_t width = 0;
+    for (const auto& l : lines) width = std::max(width, text_width(l.second));
+    const size_t l_size = l_ctx + width + 10;
+    const std::string hdr = "stability";
+
+    std::ostringstream out;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << fence(l_size / 2 - hdr.size() / 2, " ") << hdr << "\n";
+    out << fence(l_size, "–") << ANSI_RESET << "\n";
+    for (const auto& l : lines) {
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
+        if (!l.first.empty()) {
+            out << ANSI_BOLD << ANSI_RGB(143,227,125) << l.first << ANSI_RESET;
+            out << fence(l_ctx - text_width(l.first) + 2, "–") << ": ";
+        } else {
+            out << fence(l_ctx + 4, " ");
+        }
+        const bool slower = l.second.find("(+") != std::string::npos;
+        out << (slower ? ANSI_BOLD ANSI_RGB(227,143,125) : ANSI_DIM) << l.second << ANSI_RESET;
+        out << fence(width - text_width(l.second), " ");
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+    }
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << fence(l_size, "–") << ANSI_RESET << "\n";
+    return out.str();
+}
+
+/// @brief Renders the ranked jitter contributors table of the epoch report.
+std::string render_jitter(const std::vector<JitterContributor>& rows, double wall_sd, Unit unit) {
+    if (rows.empty()) return "";
+
+    size_t l_ctx{0}, l_sd{0};
+    std::vector<std::string> sds, shares, corrs;
+    for (const auto& r : rows) {
+        std::ostringstream sh, co;
+        sh << std::fixed << std::setprecision(1) << r.share * 100.0 << "%";
+        co << std::fixed << std::setprecision(2) << r.correlation;
+        sds.push_back(format(r.stddev_ns, unit) + " " + unit_suffix(unit));
+        shares.push_back(sh.str());
+        corrs.push_back(co.str());
+        l_ctx = std::max(l_ctx, text_width(r.context));
+        l_sd  = std::max(l_sd, text_width(sds.back()));
+    }
+    const size_t l_share = 7, l_corr = 5;
+
+    const std::string hdr = "jitter contributors  [wall σ " + format(wall_sd, unit) + " " + unit_suffix(unit) + "]";
+    const size_t l_body = l_ctx + 4 + l_share + 2 + std::max<size_t>(l_sd, 2) + 2 + l_corr;
+    const size_t l_size = std::max(l_body + 6, text_width(hdr) + 4);
+    const size_t hdr_w = text_width(hdr);
+
+    std::ostringstream out;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << fence(l_size / 2 > hdr_w / 2 ? l_size / 2 - hdr_w / 2 : 0, " ") << hdr << "\n";
+    out << fence(l_size, "–") << ANSI_RESET << "\n";
+
+    // Pads a row of visible width w and closes the frame.
+    auto close = [&](size_t w) {
+        out << fence(l_size - 6 - w, " ");
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+    };
+
+    const std::string head = fence(l_ctx + 4, " ") + fence(l_share - 5, " ") + "share  " +
+                             fence(std::max<size_t>(l_sd, 2) - 1, " ") + "σ  " + " corr";
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET << ANSI_DIM << head << ANSI_RESET;
+    close(text_width(head));
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        const bool gap = r.context == "untracked";
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
+        out << (gap ? ANSI_DIM : ANSI_BOLD ANSI_RGB(143,227,125)) << r.context << ANSI_RESET;
+        out << fence(l_ctx - text_width(r.context) + 2, "–") << ": ";
+        out << (i == 0 && !gap ? ANSI_BOLD ANSI_RGB(227,143,125) : ANSI_BOLD ANSI_RGB(143,227,125));
+        out << fence(l_share - shares[i].size(), " ") << shares[i] << ANSI_RESET << "  ";
+        out << fence(std::max<size_t>(l_sd, 2) - text_width(sds[i]), " ") << sds[i] << "  ";
+        out << ANSI_DIM << fence(l_corr - corrs[i].size(), " ") << corrs[i] << ANSI_RESET;
+        close(l_body);
+    }
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << fence(l_size, "–") << ANSI_RESET << "\n";
+    return out.str();
+}
+
+} // namespace
+
+std::uint32_t Jamanak::add_label(const std::string& context) {
+    if (labels.size() > PackedJam::max_label) throw std::runtime_error("too many labels");
+
+    const auto id = static_cast<std::uint32_t>(labels.size());
+    labels.push_back(context);
+    longest = std::max(longest, context.size());
+
+    const auto place = [this](std::uint32_t l) {
+        const size_t mask = label_slots.size() - 1;
+        size_t i = std::hash<std::string>{}(labels[l]) & mask;
+        while (label_slots[i]) i = (i + 1) & mask;
+        label_slots[i] = l + 1;
+    };
+    if (2 * labels.size() > label_slots.size()) {
+        label_slots.assign(std::max<size_t>(16, 4 * labels.size()), 0);
+        for (std::uint32_t l = 0; l < id; ++l) place(l);
+    }
+    place(id);
+    return id;
+}
+
+std::int64_t Jamanak::rebase(std::int64_t now) {
+    if (now < next_rebase) return 0;
+
+    std::int64_t shift = now;
+    for (const auto& j : store) shift = std::min<std::int64_t>(shift, j.start_ns);
+    for (const auto& j : jams) shift = std::min<std::int64_t>(shift, j.start_ns);
+    // Retry a quarter of the range later if old epochs still pin the origin.
+    next_rebase = now - std::max<std::int64_t>(shift, 0) + static_cast<std::int64_t>(PackedJam::max_start / 4);
+    if (shift <= 0) return 0;
+
+    const auto s = static_cast<std::uint64_t>(shift);
+    for (auto& j : store) j.start_ns -= s;
+    for (auto& j : jams) j.start_ns -= s;
+    for (auto& ep : epochs) {
+        ep.begin_ns -= shift;
+        ep.end_ns   -= shift;
+    }
+    epoch_t0 -= shift;
+    origin += std::chrono::nanoseconds(shift);
+    return shift;
+}
+
+std::int64_t Jamanak::covered_ns(JamRange js) {
+    std::vector<std::pair<std::int64_t, std::int64_t>> spans;
+    spans.reserve(js.size());
+    for (const auto& j : js) spans.emplace_back(j.start_ns, end_of(j));
+    std::sort(spans.begin(), spans.end());
+
+    std::int64_t covered = 0;
+    for (size_t i = 0; i < spans.size();) {
+        auto b = spans[i].first, e = spans[i].second;
+        for (++i; i < spans.size() && spans[i].first <= e; ++i) e = std::max(e, spans[i].second);
+        covered += e - b;
+    }
+    return covered;
+}
+
+Jamanak::LabelSamples Jamanak::gather(bool calls, bool series) const {
+    LabelSamples out;
+    const size_t none = static_cast<size_t>(-1);
+    std::vector<size_t> row(labels.size(), none);
+
+    for (size_t e = 0; e < epochs.size(); ++e) {
+        for (const auto& j : range(epochs[e])) {
+            size_t& r = row[j.label];
+            if (r == none) {
+                r = out.labels.size();
+                out.labels.push_back(labels[j.label]);
+                out.calls.emplace_back();
+                out.series.emplace_back(series ? epochs.size() : 0, 0.0);
+                out.items.push_back(0.0);
+                out.bytes.push_back(0.0);
+            }
+            if (calls) out.calls[r].push_back(static_cast<double>(j.dur_ns));
+            if (series) out.series[r][e] += static_cast<double>(j.dur_ns);
+        }
+
+        const auto& ep = epochs[e];
+        for (size_t w = ep.work_first; w < ep.work_first + ep.work_count; ++w) {
+            const size_t r = row[store[ep.first + work_store[w].jam].label];
+            out.items[r] += static_cast<double>(work_store[w].items);
+            out.bytes[r] += static_cast<double>(work_store[w].bytes);
+        }
+    }
+
+    return out;
+}
+
+std::string Jamanak::timeline(JamRange js, std::int64_t b, std::int64_t e, const std::string& hdr, size_t width) {
+    static const char* shades[] = {" ", "░", "▒", "▓", "█"};
+    width = std::max<size_t>(width, 8);
+    const double span = std::max(static_cast<double>(e - b), 1.0);
+    const double bucket = span / static_cast<double>(width);
+
+    // Rows keyed by (lane, label), ordered by lane and first appearance.
+    std::vector<std::pair<size_t, std::string>> rows;
+    std::vector<std::vector<double>> cover;
+    std::unordered_map<std::uint64_t, size_t> index;
+    std::vector<size_t> order(js.size());
+    for (size_t i = 0; i < js.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) {
+        if (js[x].thread != js[y].thread) return js[x].thread < js[y].thread;
+        return js[x].start_ns < js[y].start_ns;
+    });
+
+    for (size_t k : order) {
+        const auto& j = js[k];
+        const std::string& context = labels[j.label];
+        auto it = index.find(static_cast<std::uint64_t>(j.thread) << 32 | j.label);
+        if (it == index.end()) {
+            it = index.emplace(static_cast<std::uint64_t>(j.thread) << 32 | j.label, rows.size()).first;
+            rows.emplace_back(j.thread, j.thread ? context + " [" + std::to_string(j.thread) + "]" : context);
+            cover.emplace_back(width, 0.0);
+        }
+        auto& c = cover[it->second];
+        double from = static_cast<double>(static_cast<std::int64_t>(j.start_ns) - b);
+        double to   = static_cast<double>(end_of(j) - b);
+        from = std::max(0.0, std::min(from, span));
+        to   = std::max(from, std::min(to, span));
+        size_t c0 = std::min(width - 1, static_cast<size_t>(from / bucket));
+        size_t c1 = std::min(width - 1, static_cast<size_t>(to / bucket));
+        for (size_t x = c0; x <= c1; ++x) {
+            double lo = std::max(from, static_cast<double>(x) * bucket);
+            double hi = std::min(to, static_cast<double>(x + 1) * bucket);
+            if (hi > lo) c[x] += (hi - lo) / bucket;
+            else if (to == from) c[x] = std::max(c[x], 1e-12);
+        }
+    }
+
+    size_t l_ctx{0};
+    for (const auto& r : rows) l_ctx = std::max(l_ctx, r.second.size());
+
+    const Unit unit = pick_unit(span, Unit::automatic);
+    std::string span_str = format(span, unit) + " " + unit_suffix(unit);
+    const size_t span_w = span_str.size() - (unit == Unit::micro ? 1 : 0);
+
+    size_t l_size = std::max(l_ctx + width + 10, hdr.size() + 4);
+    size_t sf_size = l_size / 2;
+    if (hdr.size() / 2 < sf_size) sf_size -= hdr.size() / 2;
+    else sf_size = 0;
+
+    std::ostringstream out;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << fence(sf_size, " ") << hdr << "\n";
+    out << fence(l_size, "–") << "\n";
+
+    for (size_t r = 0; r < rows.size(); ++r) {
+        const auto& label = rows[r].second;
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
+        out << ANSI_BOLD << ANSI_RGB(143,227,125) << label << ANSI_RESET;
+        out << fence(l_ctx - label.size() + 2, "–") << ": ";
+        out << (rows[r].first ? ANSI_RGB(125,185,227) : ANSI_RGB(143,227,125));
+        for (double f : cover[r]) {
+            size_t level = f <= 0.0 ? 0 : std::min<size_t>(4, 1 + static_cast<size_t>(std::min(f, 1.0) * 3.999));
+            out << shades[level];
+        }
+        out << ANSI_RESET;
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+    }
+
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << ANSI_RESET << ANSI_DIM << fence(l_ctx + 7, " ") << "0";
+    if (width > span_w + 1) out << fence(width - span_w - 1, " ") << span_str;
+    out << ANSI_RESET << "\n";
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << fence(l_size, "–") << ANSI_RESET << "\n";
+
+    return out.str();
+}
+
+void Jamanak::nesting(JamRange js, std::vector<size_t>& root, std::vector<size_t>& prev) {
+    const size_t n = js.size();
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (js[a].thread != js[b].thread) return js[a].thread < js[b].thread;
+        if (js[a].start_ns != js[b].start_ns) return js[a].start_ns < js[b].start_ns;
+        return js[a].dur_ns > js[b].dur_ns;
+    });
+
+    // Walk each lane in start order with a stack of the jams still open.
+    root.assign(n, 0);
+    prev.assign(n, n);
+    std::vector<size_t> open;
+    size_t closed = n;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t v = order[i];
+        if (i && js[order[i - 1]].thread != js[v].thread) {
+            open.clear();
+            closed = n;
+        }
+        const auto t0 = static_cast<std::int64_t>(js[v].start_ns);
+        while (!open.empty() && end_of(js[open.back()]) <= t0) {
+            if (closed == n || end_of(js[open.back()]) >= end_of(js[closed])) closed = open.back();
+            open.pop_back();
+        }
+        if (open.empty()) prev[v] = closed;
+        root[v] = open.empty() ? v : open.front();
+        open.push_back(v);
+    }
+}
+
+size_t Jamanak::schedule(const Epoch& ep, std::vector<double>& ef, std::vector<double>& lf,
+                         std::vector<size_t>& pred) const {
+    const JamRange js = range(ep);
+    const size_t n = js.size();
+    std::vector<std::vector<size_t>> succ(n);
+    std::vector<size_t> indeg(n, 0);
+    auto add = [&](size_t from, size_t to) {
+        if (from >= n || to >= n) throw std::runtime_error("edge refers to unknown jam");
+        succ[from].push_back(to);
+        ++indeg[to];
+    };
+
+    // Jams on the same lane run one after the other; nested ones add no length of their own.
+    std::vector<size_t> root, prev;
+    nesting(js, root, prev);
+    for (size_t v = 0; v < n; ++v) {
+        if (prev[v] != n) add(prev[v], v);
+    }
+    for (const auto& e : ep.edges) add(e.from, e.to);
+
+    // Forward pass in topological order.
+    ef.assign(n, 0.0);
+    pred.resize(n);
+    std::vector<double> es(n, 0.0);
+    std::vector<size_t> topo, stack;
+    topo.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        pred[i] = i;
+        if (indeg[i] == 0) stack.push_back(i);
+    }
+    while (!stack.empty()) {
+        size_t v = stack.back();
+        stack.pop_back();
+        topo.push_back(v);
+        ef[v] = es[v] + static_cast<double>(js[v].dur_ns);
+        for (size_t s : succ[v]) {
+            if (pred[s] == s || ef[v] > es[s]) { es[s] = ef[v]; pred[s] = v; }
+            if (--indeg[s] == 0) stack.push_back(s);
+        }
+    }
+    if (topo.size() != n) throw std::runtime_error("dependency cycle in epoch");
+
+    size_t last = 0;
+    for (size_t i = 1; i < n; ++i) if (ef[i] > ef[last]) last = i;
+    const double length = n ? ef[last] : 0.0;
+
+    // Backward pass for latest finish times.
+    lf.assign(n, length);
+    for (auto it = topo.rbegin(); it != topo.rend(); ++it) {
+        for (size_t s : succ[*it]) lf[*it] = std::min(lf[*it], lf[s] - static_cast<double>(js[s].dur_ns));
+    }
+
+    return last;
+}
+
+std::int64_t Jamanak::untracked_ns() const { return std::max<std::int64_t>(0, wall_ns() - covered_ns(current())); }
+
+double Jamanak::epoch_untracked_ns() const {
+    if (epochs.empty()) return 0.0;
+    std::int64_t sum = 0;
+    for (const auto& ep : epochs) {
+        sum += std::max<std::int64_t>(0, ep.end_ns - ep.begin_ns - covered_ns(range(ep)));
+    }
+    return static_cast<double>(sum) / static_cast<double>(epochs.size());
+}
+
+std::vector<double> Jamanak::epoch_totals() const {
+    std::vector<double> out;
+    out.reserve(epochs.size());
+    for (const auto& ep : epochs) {
+        double sum = 0.0;
+        for (const auto& j : range(ep)) sum += static_cast<double>(j.dur_ns);
+        out.push_back(sum);
+    }
+    return out;
+}
+
+size_t Jamanak::steady_epoch(const SteadyOptions& opts) const {
+    const auto totals = epoch_totals();
+    const size_t w = std::max<size_t>(opts.window, 2);
+    if (totals.size() < w) return totals.size();
+
+    // Running sums over the window, so the scan is linear in the epoch count.
+    double sum = 0.0, sq = 0.0;
+    for (size_t i = 0; i < totals.size(); ++i) {
+        sum += totals[i];
+        sq  += totals[i] * totals[i];
+        if (i + 1 < w) continue;
+        if (i + 1 > w) {
+            sum -= totals[i - w];
+            sq  -= totals[i - w] * totals[i - w];
+        }
+        const double n = static_cast<double>(w);
+        const double mean = sum / n;
+        const double var = std::max(0.0, (sq - sum * mean) / (n - 1.0));
+        if (mean > 0.0 && std::sqrt(var) / mean <= opts.max_cv) return i + 1 - w;
+    }
+    return totals.size();
+}
+
+size_t Jamanak::steady_epoch() const {
+    return steady_epoch(SteadyOptions{});
+}
+
+size_t Jamanak::drop_warmup(const SteadyOptions& opts) {
+    const size_t k = steady_epoch(opts);
+    return k < epochs.size() ? drop_epochs(k) : 0;
+}
+
+size_t Jamanak::drop_warmup() {
+    return drop_warmup(SteadyOptions{});
+}
+
+size_t Jamanak::drop_epochs(size_t n) {
+    n = std::min(n, epochs.size());
+    if (!n) return 0;
+
+    const size_t jam_shift  = n < epochs.size() ? epochs[n].first : store.size();
+    const size_t work_shift = n < epochs.size() ? epochs[n].work_first : work_store.size();
+    store.erase(store.begin(), store.begin() + static_cast<std::ptrdiff_t>(jam_shift));
+    work_store.erase(work_store.begin(), work_store.begin() + static_cast<std::ptrdiff_t>(work_shift));
+    epochs.erase(epochs.begin(), epochs.begin() + static_cast<std::ptrdiff_t>(n));
+    for (auto& ep : epochs) {
+        ep.first      -= jam_shift;
+        ep.work_first -= work_shift;
+    }
+
+    dropped += n;
+    return n;
+}
+
+std::vector<Jam> Jamanak::epoch_averages() const {
+    if (epochs.empty()) return {};
+
+    const size_t jam_count = epochs[0].count;
+    const auto n = static_cast<std::int64_t>(epochs.size());
+    std::vector<Jam> avgs(jam_count);
+
+    for (size_t i = 0; i < jam_count; ++i) {
+        avgs[i].context = labels[store[epochs[0].first + i].label];
+        std::int64_t sum = 0;
+        for (const auto& ep : epochs) sum += static_cast<std::int64_t>(store[ep.first + i].dur_ns);
+        avgs[i].duration_ns = sum / n;
+        avgs[i].duration_ms = static_cast<double>(sum) / static_cast<double>(n) / 1e6;
+    }
+
+    return avgs;
+}
+
+std::vector<LabelStats> Jamanak::label_stats() const {
+    auto stats = label_moments();
+    if (stats.empty()) return stats;
+    auto samples = gather(true, false);
+    percentiles(samples, stats);
+    return stats;
+}
+
+std::vector<LabelStats> Jamanak::label_moments() const {
+    std::vector<StageMoments> moments(labels.size());
+    std::vector<double> items(labels.size(), 0.0), bytes(labels.size(), 0.0);
+    std::vector<std::uint32_t> order;
+
+    for (const auto& ep : epochs) {
+        for (const auto& j : range(ep)) {
+            if (!moments[j.label].count) order.push_back(j.label);
+            moments[j.label].add(static_cast<double>(j.dur_ns));
+        }
+        for (size_t w = ep.work_first; w < ep.work_first + ep.work_count; ++w) {
+            const auto label = store[ep.first + work_store[w].jam].label;
+            items[label] += static_cast<double>(work_store[w].items);
+            bytes[label] += static_cast<double>(work_store[w].bytes);
+        }
+    }
+
+    std::vector<LabelStats> out;
+    out.reserve(order.size());
+    for (auto id : order) {
+        const auto& m = moments[id];
+        out.push_back(from_moments(labels[id], m, epochs.size()));
+        out.back().items_per_s = m.sum > 0.0 ? items[id] / m.sum * 1e9 : 0.0;
+        out.back().bytes_per_s = m.sum > 0.0 ? bytes[id] / m.sum * 1e9 : 0.0;
+    }
+    return out;
+}
+
+void Jamanak::percentiles(LabelSamples& samples, std::vector<LabelStats>& stats) {
+    auto quantile = [](const std::vector<double>& v, double q) {
+        double pos = q * static_cast<double>(v.size() - 1);
+        size_t lo = static_cast<size_t>(pos);
+        size_t hi = std::min(lo + 1, v.size() - 1);
+        return v[lo] + (v[hi] - v[lo]) * (pos - static_cast<double>(lo));
+    };
+
+    for (size_t i = 0; i < stats.size(); ++i) {
+        auto& v = samples.calls[i];
+        if (v.empty()) continue;
+        std::sort(v.begin(), v.end());
+        stats[i].p50_ns = quantile(v, 0.50);
+        stats[i].p95_ns = quantile(v, 0.95);
+        stats[i].p99_ns = quantile(v, 0.99);
+    }
+}
+
+std::vector<LabelStats> Jamanak::label_stats(const BootstrapOptions& opts) const {
+    auto stats = label_moments();
+    if (stats.empty()) return stats;
+    auto samples = gather();
+    percentiles(samples, stats);
+    bootstrap(samples, stats, opts);
+    return stats;
+}
+
+void Jamanak::bootstrap(const LabelSamples& samples, std::vector<LabelStats>& stats, const BootstrapOptions& opts) {
+    const size_t reps = opts.resamples;
+    if (!reps || stats.empty()) return;
+
+    // Tasks are fixed blocks of resamples per label, each with its own stream.
+    const size_t block = 256;
+    const size_t blocks = (reps + block - 1) / block;
+    const size_t tasks = stats.size() * blocks;
+    std::vector<std::vector<double>> epoch_means(stats.size(), std::vector<double>(reps));
+    std::vector<std::vector<double>> means(stats.size(), std::vector<double>(reps));
+    std::vector<std::vector<double>> medians(stats.size(), std::vector<double>(reps));
+
+    std::atomic<size_t> next_task{0};
+    auto worker = [&] {
+        std::vector<double> draw;
+        for (size_t t = next_task++; t < tasks; t = next_task++) {
+            const size_t l = t / blocks, b = t % blocks;
+            const auto& calls  = samples.calls[l];
+            const auto& series = samples.series[l];
+            Xoshiro rng(opts.seed ^ (0x9e3779b97f4a7c15ull * (t + 1)));
+
+            draw.resize(calls.size());
+            for (size_t r = b * block; r < std::min(reps, (b + 1) * block); ++r) {
+                double sum = 0.0;
+                for (size_t k = 0; k < series.size(); ++k) sum += series[rng.below(series.size())];
+                epoch_means[l][r] = series.empty() ? 0.0 : sum / static_cast<double>(series.size());
+
+                sum = 0.0;
+                for (auto& x : draw) {
+                    x = calls[rng.below(calls.size())];
+                    sum += x;
+                }
+                means[l][r] = draw.empty() ? 0.0 : sum / static_cast<double>(draw.size());
+                if (draw.empty()) {
+                    medians[l][r] = 0.0;
+                    continue;
+                }
+                auto mid = draw.begin() + static_cast<std::ptrdiff_t>(draw.size() / 2);
+                std::nth_element(draw.begin(), mid, draw.end());
+                medians[l][r] = *mid;
+            }
+        }
+    };
+
+    size_t threads = opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, tasks);
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    const double alpha = (1.0 - std::min(std::max(opts.confidence, 0.0), 1.0)) / 2.0;
+    auto bounds = [&](std::vector<double>& v, double& lo, double& hi) {
+        std::sort(v.begin(), v.end());
+        lo = v[static_cast<size_t>(alpha * static_cast<double>(v.size() - 1) + 0.5)];
+        hi = v[static_cast<size_t>((1.0 - alpha) * static_cast<double>(v.size() - 1) + 0.5)];
+    };
+    for (size_t l = 0; l < stats.size(); ++l) {
+        bounds(epoch_means[l], stats[l].epoch_lo_ns, stats[l].epoch_hi_ns);
+        bounds(means[l], stats[l].mean_lo_ns, stats[l].mean_hi_ns);
+        bounds(medians[l], stats[l].p50_lo_ns, stats[l].p50_hi_ns);
+    }
+}
+
+std::vector<LabelStability> Jamanak::stability(const StabilityOptions& opts) const {
+    if (epochs.empty()) return {};
+    return stability(gather(false, true), opts);
+}
+
+std::vector<LabelStability> Jamanak::stability() const {
+    return stability(StabilityOptions{});
+}
+
+std::vector<LabelStability> Jamanak::stability(const LabelSamples& samples, const StabilityOptions& opts) {
+    std::vector<LabelStability> out;
+    const size_t min_seg = std::max<size_t>(opts.min_segment, 1);
+
+    for (size_t i = 0; i < samples.labels.size(); ++i) {
+        const auto& x = samples.series[i];
+        const size_t n = x.size();
+        LabelStability st;
+        st.context = samples.labels[i];
+
+        double mean = 0.0;
+        for (double v : x) mean += v;
+        mean /= static_cast<double>(std::max<size_t>(n, 1));
+        if (n < 3 || mean <= 0.0) {
+            out.push_back(st);
+            continue;
+        }
+
+        // Least-squares line through x - base; returns the slope and fills the residual sum of squares.
+        const double xm = static_cast<double>(n - 1) / 2.0;
+        double sxx = 0.0;
+        for (size_t k = 0; k < n; ++k) sxx += (static_cast<double>(k) - xm) * (static_cast<double>(k) - xm);
+        auto trend = [&](const std::vector<double>& base, double& sse) {
+            double sxy = 0.0;
+            for (size_t k = 0; k < n; ++k) sxy += (static_cast<double>(k) - xm) * (x[k] - base[k]);
+            const double slope = sxy / sxx;
+            sse = 0.0;
+            for (size_t k = 0; k < n; ++k) {
+                const double r = x[k] - base[k] - slope * (static_cast<double>(k) - xm);
+                sse += r * r;
+            }
+            return slope;
+        };
+
+        // Level of every epoch's segment; without change points it is the overall mean.
+        std::vector<double> level(n, mean);
+        std::vector<size_t> bounds{0, n};
+        if (n >= 2 * min_seg) {
+            // Noise from the median absolute successive difference: robust to the shifts themselves.
+            std::vector<double> diffs;
+            for (size_t k = 1; k < n; ++k) diffs.push_back(std::fabs(x[k] - x[k - 1]));
+            std::nth_element(diffs.begin(), diffs.begin() + static_cast<std::ptrdiff_t>(diffs.size() / 2), diffs.end());
+            const double sigma = std::max(1.4826 * diffs[diffs.size() / 2] / std::sqrt(2.0), 1e-3 * mean);
+            const double beta = opts.penalty * sigma * sigma * std::log(static_cast<double>(n));
+
+            const auto cps = pelt(x, beta, min_seg);
+            std::vector<double> steps(n);
+            double steps_sse = 0.0;
+            for (size_t c = 0; c <= cps.size(); ++c) {
+                const size_t a = c ? cps[c - 1] : 0, b = c < cps.size() ? cps[c] : n;
+                double sum = 0.0;
+                for (size_t k = a; k < b; ++k) sum += x[k];
+                for (size_t k = a; k < b; ++k) {
+                    steps[k] = sum / static_cast<double>(b - a);
+                    steps_sse += (x[k] - steps[k]) * (x[k] - steps[k]);
+                }
+            }
+
+            // A staircase that a single line explains at least as well is drift, not a set of shifts.
+            double line_sse = 0.0;
+            trend(level, line_sse);
+            if (!cps.empty() && steps_sse + beta * static_cast<double>(cps.size()) < line_sse + beta) {
+                level = steps;
+                bounds.insert(bounds.begin() + 1, cps.begin(), cps.end());
+            }
+        }
+
+        for (size_t c = 1; c + 1 < bounds.size(); ++c) {
+            const double before = level[bounds[c] - 1], after = level[bounds[c]];
+            if (std::fabs(after - before) >= opts.min_shift * mean) st.changes.push_back({bounds[c], before, after});
+        }
+
+        double sse = 0.0;
+        st.slope_ns = trend(level, sse);
+        const double se = std::sqrt(sse / static_cast<double>(n - 2) / sxx);
+        st.slope_t  = se > 0.0 ? st.slope_ns / se : 0.0;
+        st.drifting = std::fabs(st.slope_t) >= opts.drift_t &&
+                      std::fabs(st.slope_ns) * static_cast<double>(n) >= opts.min_shift * mean;
+
+        out.push_back(st);
+    }
+
+    return out;
+}
+
+std::vector<JitterContributor> Jamanak::jitter_contributors() const {
+    if (epochs.size() < 2) return {};
+
+    // Columns: one per interned label plus the untracked remainder (last).
+    const size_t cols = labels.size() + 1;
+    std::vector<double> row(cols), mean(cols, 0.0), m2(cols, 0.0), co(cols, 0.0);
+    std::vector<char> seen(labels.size(), 0);
+    double wall_mean = 0.0, wall_m2 = 0.0;
+
+    // Every covered instant is attributed to exactly one jam: across lanes the one on the
+    // critical path, among nested jams the innermost (latest start). The label times then
+    // sum to covered_ns(), and the untracked column is the same gap the report shows.
+    struct Event {
+        std::int64_t t;                                    ///< Time, ns since origin.
+        size_t jam;                                        ///< Jam id within the epoch.
+        bool open;                                         ///< Start (true) or end (false) of the jam.
+    };
+    std::vector<Event> events;
+    std::vector<char> on_path;
+    std::vector<size_t> root, prev;
+    std::set<std::tuple<char, std::uint64_t, size_t>> active;
+
+    for (size_t e = 0; e < epochs.size(); ++e) {
+        const auto& ep = epochs[e];
+        const auto js = range(ep);
+        std::fill(row.begin(), row.end(), 0.0);
+
+        on_path.assign(js.size(), 0);
+        bool lanes = false;
+        for (const auto& j : js) lanes = lanes || j.thread != 0;
+        if (lanes) {
+            // Jams nested in a critical one share its priority, so the innermost still wins.
+            for (size_t id : critical_path(e)) on_path[id] = 1;
+            nesting(js, root, prev);
+            for (size_t i = 0; i < js.size(); ++i) on_path[i] = on_path[root[i]];
+        }
+
+        events.clear();
+        for (size_t i = 0; i < js.size(); ++i) {
+            events.push_back({static_cast<std::int64_t>(js[i].start_ns), i, true});
+            events.push_back({end_of(js[i]), i, false});
+            seen[js[i].label] = 1;
+        }
+        std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.t < b.t; });
+
+        double covered = 0.0;
+        active.clear();
+        for (size_t k = 0; k < events.size(); ++k) {
+            if (k && !active.empty()) {
+                const double dt = static_cast<double>(events[k].t - events[k - 1].t);
+                row[js[std::get<2>(*active.rbegin())].label] += dt;
+                covered += dt;
+            }
+            const size_t i = events[k].jam;
+            const auto key = std::make_tuple(on_path[i], static_cast<std::uint64_t>(js[i].start_ns), i);
+            if (events[k].open) active.insert(key);
+            else active.erase(key);
+        }
+
+        const double wall = static_cast<double>(ep.end_ns - ep.begin_ns);
+        row[cols - 1] = std::max(0.0, wall - covered);
+
+        // Welford co-moments: dw uses the old wall mean, the update the new one.
+        const double n  = static_cast<double>(e + 1);
+        const double dw = wall - wall_mean;
+        wall_mean += dw / n;
+        wall_m2   += dw * (wall - wall_mean);
+        for (size_t c = 0; c < cols; ++c) {
+            const double d = row[c] - mean[c];
+            mean[c] += d / n;
+            m2[c]   += d * (row[c] - mean[c]);
+            co[c]   += d * (wall - wall_mean);
+        }
+    }
+
+    const double dof = static_cast<double>(epochs.size() - 1);
+    const double wall_var = wall_m2 / dof;
+    std::vector<JitterContributor> out;
+    for (size_t c = 0; c < cols; ++c) {
+        if (c + 1 < cols && !seen[c]) continue;
+        JitterContributor jc;
+        jc.context     = c + 1 < cols ? labels[c] : "untracked";
+        jc.stddev_ns   = std::sqrt(m2[c] / dof);
+        jc.covariance  = co[c] / dof;
+        jc.correlation = jc.stddev_ns > 0.0 && wall_var > 0.0 ? jc.covariance / (jc.stddev_ns * std::sqrt(wall_var)) : 0.0;
+        jc.share       = wall_var > 0.0 ? jc.covariance / wall_var : 0.0;
+        out.push_back(jc);
+    }
+    std::stable_sort(out.begin(), out.end(),
+                     [](const JitterContributor& a, const JitterContributor& b) { return a.share > b.share; });
+    return out;
+}
+
+std::vector<size_t> Jamanak::critical_path(size_t epoch) const {
+    const auto& ep = epochs.at(epoch);
+    if (ep.count == 0) return {};
+
+    std::vector<double> ef, lf;
+    std::vector<size_t> pred;
+    size_t v = schedule(ep, ef, lf, pred);
+
+    std::vector<size_t> path{v};
+    while (pred[v] != v) { v = pred[v]; path.push_back(v); }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+double Jamanak::critical_path_ns() const {
+    if (epochs.empty()) return 0.0;
+    double sum = 0.0;
+    std::vector<double> ef, lf;
+    std::vector<size_t> pred;
+    for (const auto& ep : epochs) {
+        if (ep.count == 0) continue;
+        sum += ef[schedule(ep, ef, lf, pred)];
+    }
+    return sum / static_cast<double>(epochs.size());
+}
+
+std::vector<CriticalLabel> Jamanak::critical_labels() const {
+    std::vector<CriticalLabel> out;
+    std::vector<size_t> slack_n;
+    std::vector<double> ef, lf;
+    std::vector<size_t> pred;
+    const size_t none = static_cast<size_t>(-1);
+    std::vector<size_t> row(labels.size(), none);
+
+    auto index_of = [&](std::uint32_t label) {
+        if (row[label] == none) {
+            row[label] = out.size();
+            out.push_back({labels[label], 0, 0.0});
+            slack_n.push_back(0);
+        }
+        return row[label];
+    };
+
+    for (const auto& ep : epochs) {
+        if (ep.count == 0) continue;
+        const JamRange js = range(ep);
+        size_t v = schedule(ep, ef, lf, pred);
+
+        for (size_t i = 0; i < js.size(); ++i) {
+            size_t idx = index_of(js[i].label);
+            out[idx].mean_slack_ns += std::max(0.0, lf[i] - ef[i]);
+            ++slack_n[idx];
+        }
+
+        std::vector<bool> seen(out.size(), false);
+        for (;;) {
+            size_t idx = index_of(js[v].label);
+            if (!seen[idx]) { seen[idx] = true; ++out[idx].on_path; }
+            if (pred[v] == v) break;
+            v = pred[v];
+        }
+    }
+
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (slack_n[i]) out[i].mean_slack_ns /= static_cast<double>(slack_n[i]);
+    }
+    return out;
+}
+
+std::string Jamanak::to_string(Unit unit) {
+    std::ostringstream out;
+    const std::string gap_label = "untracked";
+    const size_t l_ctx = std::max(longest, gap_label.size());
+    const auto wall = static_cast<double>(wall_ns());
+    const auto gap = static_cast<double>(untracked_ns());
+
+    std::uint64_t longest_ns = 0;
+    for (const auto& j : jams) longest_ns = std::max<std::uint64_t>(longest_ns, j.dur_ns);
+    unit = pick_unit(static_cast<double>(longest_ns), unit);
+    const std::string suffix = std::string(" ") + unit_suffix(unit);
+
+    std::ostringstream pct_ss;
+    pct_ss  << std::fixed << std::setprecision(1) << (wall > 0.0 ? gap / wall * 100.0 : 0.0);
+    std::string gap_str = format(gap, unit), wall_str = format(wall, unit);
+
+    std::vector<std::string> dur_strs;
+    size_t l_dur = std::max(gap_str.size(), wall_str.size());
+    size_t safe_bc = std::max(get_shift(gap_str), get_shift(wall_str));
+    double total = 0.0;
+    for (const auto& j : jams) {
+        dur_strs.push_back(format(static_cast<double>(j.dur_ns), unit));
+        l_dur   = std::max(l_dur, dur_strs.back().size());
+        safe_bc = std::max(safe_bc, get_shift(dur_strs.back()));
+        total  += static_cast<double>(j.dur_ns);
+    }
+    std::string tot_str = format(total, unit);
+    safe_bc = std::max(safe_bc, get_shift(tot_str));
+
+    // Throughput of annotated jams.
+    std::vector<std::string> item_strs(jams.size()), byte_strs(jams.size());
+    size_t l_items{0}, l_bytes{0};
+    for (const auto& w : work) {
+        const double dur = static_cast<double>(std::max<std::uint64_t>(jams[w.jam].dur_ns, 1));
+        if (w.items) item_strs[w.jam] = items_rate(static_cast<double>(w.items) / dur * 1e9).insert(0, "  ");
+        if (w.bytes) byte_strs[w.jam] = bytes_rate(static_cast<double>(w.bytes) / dur * 1e9).insert(0, "  ");
+        l_items = std::max(l_items, item_strs[w.jam].size());
+        l_bytes = std::max(l_bytes, byte_strs[w.jam].size());
+    }
+
+    size_t l_size = std::max(l_ctx + l_dur + 9 + l_items + l_bytes, global_context.size()) + 13;
+    size_t sf_size = static_cast<size_t>(l_size / 2) - static_cast<size_t>(global_context.size() / 2);
+    size_t j_context_size{0};
+
+    auto old_flags = out.flags();
+    auto old_prec  = out.precision();
+
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << fence(sf_size, " ");
+    out << global_context.c_str();
+    out << "\n";
+    out << fence(l_size, "–") << "\n";
+
+    for (size_t i = 0; i < jams.size(); ++i) {
+        const auto& context = labels[jams[i].label];
+        const auto& s = dur_strs[i];
+        j_context_size = context.size();
+
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
+        out << ANSI_BOLD << ANSI_RGB(143,227,125) << context.c_str() << ANSI_RESET;
+        out << fence(l_ctx - j_context_size + 2, "–") << ": ";
+        out << ANSI_BOLD << ANSI_RGB(143,227,125);
+        out << fence(safe_bc - get_shift(s), " ") << s << ANSI_RESET;
+        out << suffix;
+        if (l_items) out << fence(l_items - item_strs[i].size(), " ") << item_strs[i];
+        if (l_bytes) out << fence(l_bytes - byte_strs[i].size(), " ") << byte_strs[i];
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+    }
+
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
+    out << ANSI_DIM << gap_label << ANSI_RESET;
+    out << fence(l_ctx - gap_label.size() + 2, "–") << ": ";
+    out << ANSI_DIM;
+    out << fence(safe_bc - get_shift(gap_str), " ") << gap_str << suffix << "  ";
+    out << "(" << pct_ss.str() << "%)" << ANSI_RESET;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << "|| total ──: ";
+    out << ANSI_RGB(143,227,125);
+    out << fence(safe_bc - get_shift(tot_str), " ") << tot_str << ANSI_RESET;
+    out << suffix << "\n";
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << "|| wall ───: ";
+    out << ANSI_RGB(143,227,125);
+    out << fence(safe_bc - get_shift(wall_str), " ") << wall_str << ANSI_RESET;
+    out << suffix;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << "\n";
+    out << fence(l_size, "–") << ANSI_RESET << "\n";
+
+    out.flags(old_flags);
+    out.precision(old_prec);
+
+    return out.str() + render_saturated(saturated);
+}
+
+std::string Jamanak::to_string_epochs(const ReportOptions& opts) {
+    if (epochs.empty()) return "";
+
+    // The default table needs only running moments; per-call samples, their sort and the
+    // dense per-epoch series are built only for the columns and sections that use them.
+    const bool need_calls  = (opts.columns & (col_p50 | col_p95 | col_p99)) || opts.histogram || opts.bootstrap;
+    const bool need_series = opts.sparkline || opts.stability || opts.bootstrap;
+    LabelSamples samples;
+    if (need_calls || need_series) samples = gather(need_calls, need_series);
+    auto stats = label_moments();
+    if (need_calls) percentiles(samples, stats);
+    if (opts.bootstrap) {
+        BootstrapOptions bo;
+        bo.resamples  = opts.bootstrap;
+        bo.confidence = opts.confidence;
+        bootstrap(samples, stats, bo);
+    }
+    std::string stable;
+    if (opts.stability) {
+        double longest_ns = 0.0;
+        for (const auto& st : stats) longest_ns = std::max(longest_ns, st.epoch_ns);
+        stable = render_stability(stability(samples, {}), pick_unit(longest_ns, opts.unit));
+    }
+    std::string jitter;
+    if (opts.jitter) {
+        auto rows = jitter_contributors();
+        double wall_var = 0.0;
+        for (const auto& r : rows) wall_var += r.covariance;
+        const double wall_sd = std::sqrt(std::max(0.0, wall_var));
+        double widest = 0.0;
+        for (const auto& r : rows) widest = std::max(widest, r.stddev_ns);
+        jitter = render_jitter(rows, wall_sd, pick_unit(std::max(widest, wall_sd), opts.unit));
+    }
+    return render_epochs(global_context, epochs.size(), std::move(stats), need_calls || need_series ? &samples : nullptr,
+                         epoch_wall_ns(), epoch_untracked_ns(), opts, dropped) + render_saturated(saturated) + jitter + stable +
+           render_environment(environment());
+}
+
+std::string Jamanak::to_string_epochs() {
+    return to_string_epochs(ReportOptions{});
+}
+
+void Jamanak::set_environment(const Environment& environment) {
+    env = std::make_shared<const Environment>(environment);
+}
+
+const Environment& Jamanak::environment() const {
+    static const Environment none;
+    return env ? *env : none;
+}
+
+std::string Jamanak::to_json() const {
+    std::ostringstream out;
+    out << std::setprecision(10);
+    out << "{\n  \"context\": " << json_string(global_context) << ",\n";
+    out << "  \"epochs\": " << epochs.size() << ",\n";
+    out << "  \"dropped_epochs\": " << dropped << ",\n";
+    out << "  \"saturated_jams\": " << saturated << ",\n";
+    out << "  \"wall_ns\": " << epoch_wall_ns() << ",\n";
+    out << "  \"untracked_ns\": " << epoch_untracked_ns() << ",\n";
+
+    out << "  \"labels\": [";
+    const auto stats = label_stats();
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const auto& st = stats[i];
+        out << (i ? ",\n" : "\n") << "    {\"context\": " << json_string(st.context)
+            << ", \"count\": " << st.count << ", \"epoch_ns\": " << st.epoch_ns
+            << ", \"mean_ns\": " << st.mean_ns << ", \"min_ns\": " << st.min_ns << ", \"max_ns\": " << st.max_ns
+            << ", \"stddev_ns\": " << st.stddev_ns << ", \"cv\": " << st.cv
+            << ", \"p50_ns\": " << st.p50_ns << ", \"p95_ns\": " << st.p95_ns << ", \"p99_ns\": " << st.p99_ns
+            << ", \"calls_per_s\": " << st.calls_per_s << ", \"items_per_s\": " << st.items_per_s
+            << ", \"bytes_per_s\": " << st.bytes_per_s << "}";
+    }
+    out << (stats.empty() ? "]" : "\n  ]");
+
+    const Environment& env = environment();
+    if (env.probed) {
+        out << ",\n  \"environment\": {\"host\": " << json_string(env.host)
+            << ", \"cpu_model\": " << json_string(env.cpu_model) << ", \"cpus\": " << env.cpus
+            << ", \"cpu\": " << env.cpu << ", \"smt_siblings\": " << json_string(env.siblings)
+            << ", \"nice\": " << env.nice << ", \"governor\": " << json_string(env.governor)
+            << ", \"turbo\": " << env.turbo
+            << ", \"load\": [" << env.load[0] << ", " << env.load[1] << ", " << env.load[2] << "]"
+            << ", \"warnings\": [";
+        for (size_t i = 0; i < env.warnings.size(); ++i) out << (i ? ", " : "") << json_string(env.warnings[i]);
+        out << "]}";
+    }
+    out << "\n}\n";
+    return out.str();
+}
+
+std::string Jamanak::render_epochs(const std::string& context, size_t n_epochs, std::vector<LabelStats> stats,
+                                   const LabelSamples* samples, double wall, double untracked,
+                                   ReportOptions opts, size_t n_dropped) {
+    if (!samples) opts.histogram = opts.sparkline = false;
+
+    double total = 0.0, longest_ns = 0.0;
+    for (const auto& st : stats) {
+        total += st.epoch_ns;
+        longest_ns = std::max(longest_ns, st.epoch_ns);
+    }
+
+    const Unit unit = pick_unit(longest_ns, opts.unit);
+    const std::string suffix = std::string(" ") + unit_suffix(unit);
+    const size_t suffix_w = unit == Unit::sec ? 2 : 3;
+
+    const double base = wall > 0.0 ? wall : total;
+    LabelStats gap;
+    gap.context = "untracked";
+    gap.epoch_ns = untracked;
+    stats.push_back(gap);
+
+    size_t l_ctx{0}, l_bc{0}, l_dur{0}, l_pct{0}, l_ci{0};
+    std::vector<std::string> dur_strs, pct_strs, ci_strs;
+
+    for (const auto& st : stats) {
+        l_ctx = std::max(l_ctx, st.context.size());
+        std::string s = format(st.epoch_ns, unit);
+        dur_strs.push_back(s);
+
+        // Bootstrap intervals are shown as a symmetric "± half-width" (the wider side).
+        ci_strs.emplace_back();
+        if (st.epoch_hi_ns > st.epoch_lo_ns) {
+            ci_strs.back() = " ± " + format(std::max(st.epoch_hi_ns - st.epoch_ns, st.epoch_ns - st.epoch_lo_ns), unit);
+        }
+        l_ci = std::max(l_ci, text_width(ci_strs.back()));
+        l_dur = std::max(l_dur, s.size());
+        l_bc  = std::max(l_bc,  get_shift(s));
+
+        std::ostringstream pct_ss;
+        pct_ss << "(" << std::fixed << std::setprecision(1) << (base > 0.0 ? st.epoch_ns / base * 100.0 : 0.0) << "%)";
+        pct_strs.push_back(pct_ss.str());
+        l_pct = std::max(l_pct, pct_strs.back().size());
+    }
+
+    std::string tot_str = format(total, unit);
+    std::string wall_str = format(wall, unit);
+    l_bc = std::max({l_bc, get_shift(tot_str), get_shift(wall_str)});
+    const size_t l_frac = tot_str.size() - get_shift(tot_str);
+
+    // Optional distribution columns, one cell string per label.
+    static const std::pair<unsigned, const char*> column_names[] = {
+        {col_count, "n"}, {col_min, "min"}, {col_max, "max"}, {col_stddev, "stddev"},
+        {col_cv, "cv"}, {col_p50, "p50"}, {col_p95, "p95"}, {col_p99, "p99"},
+        {col_throughput, "calls/s"}, {col_items, "items/s"}, {col_bytes, "bytes/s"},
+    };
+    std::vector<const char*> col_hdrs;
+    std::vector<size_t> col_w;
+    std::vector<std::vector<std::string>> cells(stats.size() - 1);
+
+    for (const auto& c : column_names) {
+        if (!(opts.columns & c.first)) continue;
+        size_t w = std::strlen(c.second);
+        for (size_t i = 0; i + 1 < stats.size(); ++i) {
+            const auto& st = stats[i];
+            std::ostringstream ss;
+            ss << std::fixed;
+            switch (c.first) {
+                case col_count:      ss << st.count; break;
+                case col_min:        ss << format(st.min_ns, unit); break;
+                case col_max:        ss << format(st.max_ns, unit); break;
+                case col_stddev:     ss << format(st.stddev_ns, unit); break;
+                case col_cv:         ss << std::setprecision(1) << st.cv * 100.0 << "%"; break;
+                case col_p50:        ss << format(st.p50_ns, unit); break;
+                case col_p95:        ss << format(st.p95_ns, unit); break;
+                case col_p99:        ss << format(st.p99_ns, unit); break;
+                case col_throughput: ss << std::setprecision(1) << st.calls_per_s; break;
+                case col_items:      ss << (st.items_per_s > 0.0 ? items_rate(st.items_per_s) : "-"); break;
+                case col_bytes:      ss << (st.bytes_per_s > 0.0 ? bytes_rate(st.bytes_per_s) : "-"); break;
+                default: break;
+            }
+            cells[i].push_back(ss.str());
+            w = std::max(w, cells[i].back().size());
+        }
+        col_hdrs.push_back(c.second);
+        col_w.push_back(w);
+    }
+
+    // Optional distribution shapes; block characters are one column but three bytes wide.
+    std::vector<std::string> hists(stats.size() - 1), sparks(stats.size() - 1);
+    size_t l_spark{0};
+    for (size_t i = 0; i + 1 < stats.size(); ++i) {
+        if (opts.histogram) hists[i] = histogram(samples->calls[i], opts.histogram_bins);
+        if (opts.sparkline) sparks[i] = sparkline(samples->series[i], opts.sparkline_width, l_spark);
+    }
+    if (opts.histogram) {
+        col_hdrs.push_back("histogram");
+        col_w.push_back(std::max<size_t>(opts.histogram_bins, 9));
+    }
+    if (opts.sparkline) {
+        col_hdrs.push_back("trend");
+        col_w.push_back(std::max<size_t>(l_spark, 5));
+    }
+
+    size_t l_cols{0};
+    for (size_t w : col_w) l_cols += w + 2;
+
+    std::string hdr = context + "  [" + std::to_string(n_epochs) + " epochs";
+    if (n_dropped) hdr += ", " + std::to_string(n_dropped) + " warmup dropped";
+    hdr += "]";
+    size_t l_size = std::max(l_ctx + l_dur + l_ci + l_pct + l_cols + 18, hdr.size() + 4);
+    size_t sf_size = l_size / 2;
+    if (hdr.size() / 2 < sf_size) sf_size -= hdr.size() / 2;
+    else sf_size = 0;
+
+    std::ostringstream out;
+    auto old_flags = out.flags();
+    auto old_prec  = out.precision();
+
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << fence(sf_size, " ") << hdr << "\n";
+    out << fence(l_size, "–") << "\n";
+
+    if (!col_hdrs.empty()) {
+        out << "|| " << ANSI_RESET << ANSI_DIM;
+        out << fence(l_ctx + 4 + l_bc + l_frac + l_ci + suffix_w + 2 + l_pct, " ");
+        for (size_t c = 0; c < col_hdrs.size(); ++c) {
+            out << "  " << fence(col_w[c] - std::strlen(col_hdrs[c]), " ") << col_hdrs[c];
+        }
+        out << ANSI_RESET << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+    }
+
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const auto& st  = stats[i];
+        const auto& s   = dur_strs[i];
+        const bool is_gap = i + 1 == stats.size();
+        const bool noisy  = !is_gap && st.count > 1 && st.cv > opts.noisy_cv;
+
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
+        if (is_gap) out << ANSI_DIM;
+        else if (noisy) out << ANSI_BOLD << ANSI_RGB(227,143,125);
+        else out << ANSI_BOLD << ANSI_RGB(143,227,125);
+        out << st.context.c_str() << ANSI_RESET;
+        out << fence(l_ctx - st.context.size() + 2, "–") << ": ";
+        if (is_gap) out << ANSI_DIM;
+        else if (noisy) out << ANSI_BOLD << ANSI_RGB(227,143,125);
+        else out << ANSI_BOLD << ANSI_RGB(143,227,125);
+        out << fence(l_bc - get_shift(s), " ") << s << ANSI_RESET;
+        if (l_ci) out << ANSI_DIM << ci_strs[i] << ANSI_RESET << fence(l_ci - text_width(ci_strs[i]), " ");
+        out << suffix << "  ";
+        out << ANSI_DIM << pct_strs[i] << ANSI_RESET;
+
+        if (!col_hdrs.empty()) {
+            out << fence(l_pct - pct_strs[i].size(), " ");
+            size_t c = 0;
+            for (; !is_gap && c < cells[i].size(); ++c) {
+                out << "  " << fence(col_w[c] - cells[i][c].size(), " ") << cells[i][c];
+            }
+            if (!is_gap && opts.histogram) {
+                out << "  " << ANSI_RGB(143,227,125) << hists[i] << ANSI_RESET;
+                out << fence(col_w[c++] - opts.histogram_bins, " ");
+            }
+            if (!is_gap && opts.sparkline) {
+                out << "  " << ANSI_RGB(143,227,125) << sparks[i] << ANSI_RESET;
+                out << fence(col_w[c++] - l_spark, " ");
+            }
+            for (; c < col_hdrs.size(); ++c) out << "  " << fence(col_w[c], " ");
+        }
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+    }
+
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << "|| total ──: ";
+    out << ANSI_RGB(143,227,125);
+    out << fence(l_bc - get_shift(tot_str), " ") << tot_str << ANSI_RESET;
+    out << suffix << "\n";
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << "|| wall ───: ";
+    out << ANSI_RGB(143,227,125);
+    out << fence(l_bc - get_shift(wall_str), " ") << wall_str << ANSI_RESET;
+    out << suffix;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << "\n";
+    out << fence(l_size, "–") << ANSI_RESET << "\n";
+
+    out.flags(old_flags);
+    out.precision(old_prec);
+
+    return out.str();
+}
+
+std::vector<LabelStats> Jamanak::stage_stats(const char* const* names, const StageMoments* moments,
+                                             size_t n, size_t n_epochs) {
+    std::vector<LabelStats> out;
+    if (!n_epochs) return out;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (moments[i].count) out.push_back(from_moments(names[i], moments[i], n_epochs));
+    }
+
+    return out;
+}
+
+std::string Jamanak::render_stages(const char* context, const char* const* names, const StageMoments* moments,
+                                   size_t n, size_t n_epochs, double wall, double untracked,
+                                   const ReportOptions& opts) {
+    if (!n_epochs) return "";
+
+    ReportOptions o = opts;
+    o.columns &= ~static_cast<unsigned>(col_p50 | col_p95 | col_p99 | col_items | col_bytes);
+    return render_epochs(context, n_epochs, stage_stats(names, moments, n, n_epochs), nullptr,
+                         wall, untracked, o);
+}
+
+std::string Jamanak::to_timeline(size_t width) {
+    if (jams.empty()) return "";
+    std::int64_t t1 = 0;
+    for (const auto& j : jams) t1 = std::max(t1, end_of(j));
+    return timeline(current(), wall_begin(), t1, global_context + "  [timeline]", width);
+}
+
+std::string Jamanak::to_timeline_epoch(size_t epoch, size_t width) {
+    const auto& ep = epochs.at(epoch);
+    return timeline(range(ep), ep.begin_ns, ep.end_ns,
+                    global_context + "  [timeline, epoch " + std::to_string(epoch) + "]", width);
+}
+
+std::string Jamanak::to_string_critical_path(Unit unit) {
+    if (epochs.empty()) return "";
+
+    auto labels = critical_labels();
+    const double path = critical_path_ns();
+    double sum = 0.0;
+    for (const auto& j : store) sum += static_cast<double>(j.dur_ns);
+    sum /= static_cast<double>(epochs.size());
+
+    unit = pick_unit(path, unit);
+    const std::string suffix = std::string(" ") + unit_suffix(unit);
+
+    size_t l_ctx{0}, l_bc{0}, l_dur{0};
+    std::vector<std::string> slack_strs;
+
+    for (const auto& l : labels) {
+        l_ctx = std::max(l_ctx, l.context.size());
+        std::string s = format(l.mean_slack_ns, unit);
+        slack_strs.push_back(s);
+        l_dur = std::max(l_dur, s.size());
+        l_bc  = std::max(l_bc,  get_shift(s));
+    }
+
+    std::string path_str = format(path, unit), sum_str = format(sum, unit);
+    size_t t_bc = std::max(get_shift(path_str), get_shift(sum_str));
+
+    std::string hdr = global_context + "  [critical path, " + std::to_string(epochs.size()) + " epochs]";
+    size_t l_size = std::max(l_ctx + l_dur + 30, hdr.size() + 4);
+    size_t sf_size = l_size / 2;
+    if (hdr.size() / 2 < sf_size) sf_size -= hdr.size() / 2;
+    else sf_size = 0;
+
+    std::ostringstream out;
+
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << fence(sf_size, " ") << hdr << "\n";
+    out << fence(l_size, "–") << "\n";
+
+    const std::string n_str = std::to_string(epochs.size());
+    for (size_t i = 0; i < labels.size(); ++i) {
+        const auto& l = labels[i];
+        const auto& s = slack_strs[i];
+        std::string share = std::to_string(l.on_path) + "/" + n_str;
+
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
+        out << ANSI_BOLD << ANSI_RGB(143,227,125) << l.context.c_str() << ANSI_RESET;
+        out << fence(l_ctx - l.context.size() + 2, "–") << ": ";
+        out << "on path " << fence(2 * n_str.size() + 1 - share.size(), " ") << share;
+        out << "  slack ";
+        out << ANSI_BOLD << ANSI_RGB(143,227,125);
+        out << fence(l_bc - get_shift(s), " ") << s << ANSI_RESET;
+        out << suffix;
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+    }
+
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << "|| path ───: ";
+    out << ANSI_RGB(143,227,125);
+    out << fence(t_bc - get_shift(path_str), " ") << path_str << ANSI_RESET;
+    out << suffix << "\n";
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << "|| sum ────: ";
+    out << ANSI_RGB(143,227,125);
+    out << fence(t_bc - get_shift(sum_str), " ") << sum_str << ANSI_RESET;
+    out << suffix;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127) << "\n";
+    out << fence(l_size, "–") << ANSI_RESET << "\n";
+
+    return out.str();
+}
+
+} // namespace jamanak
@@ -0,0 +1,107 @@
+#pragma once
+
+/// @file jamanak_format.hpp
+/// @brief Internal table formatting helpers shared by the report renderers (not installed).
+
+#include "jamanak.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace jamanak {
+namespace format_detail {
+
+/// @brief Returns @p n repetitions of the string @p f.
+inline std::string fence(const int n, const std::string f) {
+    std::ostringstream out;
+    for (size_t i = 0; i < n; i++) { out << f; }
+    return out.str();
+}
+
+/// @brief Returns the number of characters before the decimal point in @p num.
+inline size_t get_shift(const std::string num) {
+    auto idx = num.find(".");
+    auto s = num.substr(0, idx);
+    return s.size();
+}
+
+/// @brief Returns the number of terminal columns of UTF-8 @p s (one per code point, no escapes).
+inline size_t text_width(const std::string& s) {
+    size_t n = 0;
+    for (unsigned char c : s) n += (c & 0xC0) != 0x80;
+    return n;
+}
+
+/// @brief Returns the number of nanoseconds in one @p unit.
+inline double unit_ns(Unit unit) {
+    switch (unit) {
+        case Unit::nano:  return 1.0;
+        case Unit::micro: return 1e3;
+        case Unit::sec:   return 1e9;
+        default:          return 1e6;
+    }
+}
+
+/// @brief Returns the suffix printed after values in @p unit.
+inline const char* unit_suffix(Unit unit) {
+    switch (unit) {
+        case Unit::nano:  return "ns";
+        case Unit::micro: return "µs";
+        case Unit::sec:   return "s";
+        default:          return "ms";
+    }
+}
+
+/// @brief Resolves @p unit; `automatic` becomes the largest unit in which @p ns is at least one.
+inline Unit pick_unit(double ns, Unit unit) {
+    if (unit != Unit::automatic) return unit;
+    if (ns < 1e3) return Unit::nano;
+    if (ns < 1e6) return Unit::micro;
+    if (ns < 1e9) return Unit::milli;
+    return Unit::sec;
+}
+
+/// @brief Formats @p ns in @p unit with the unit's fixed precision (no suffix).
+inline std::string format(double ns, Unit unit) {
+    static const int precision[] = {5, 0, 6, 3, 5};
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(precision[unit]) << ns / unit_ns(unit);
+    return ss.str();
+}
+
+/// @brief Formats a rate with an SI (1000) or IEC (1024) prefix, e.g. "12.35 M" or "1.21 Gi".
+inline std::string scaled(double v, bool iec) {
+    static const char* si[]  = {"", "k", "M", "G", "T", "P"};
+    static const char* bin[] = {"", "Ki", "Mi", "Gi", "Ti", "Pi"};
+    const double step = iec ? 1024.0 : 1000.0;
+    size_t p = 0;
+    while (v >= step && p < 5) {
+        v /= step;
+        ++p;
+    }
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2) << v << " " << (iec ? bin[p] : si[p]);
+    return ss.str();
+}
+
+/// @brief Formats @p items per second, e.g. "12.35 M/s".
+inline std::string items_rate(double per_s) { return scaled(per_s, false) + "/s"; }
+
+/// @brief Formats @p bytes per second, e.g. "1.21 GiB/s".
+inline std::string bytes_rate(double per_s) { return scaled(per_s, true) + "B/s"; }
+
+/// @brief Returns @p s as a quoted JSON string.
+inline std::string json_string(const std::string& s) {
+    std::ostringstream out;
+    out << '"';
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (c < 0x20) out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        else out << c;
+    }
+    out << '"';
+    return out.str();
+}
+
+} // namespace format_detail
+} // namespace jamanak
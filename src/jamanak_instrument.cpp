@@ -0,0 +1,182 @@
+/// @file jamanak_instrument.cpp
+/// @brief `__cyg_profile_func_enter/exit` hooks recording into per-thread buffers.
+///
+/// This file must not be compiled with `-finstrument-functions` itself.
+
+#include "jamanak_instrument.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+
+#define JAMANAK_NO_INSTRUMENT __attribute__((no_instrument_function))
+
+namespace jamanak {
+namespace instrument {
+
+namespace {
+
+/// @brief An instrumented call that has not returned yet.
+struct Frame {
+    void* fn;                                              ///< Function address.
+    Clock::time_point t0;                                  ///< Entry time.
+    std::int64_t child_ns;                                 ///< Time spent in nested calls so far.
+};
+
+/// @brief A completed instrumented call.
+struct Call {
+    void* fn;                                              ///< Function address.
+    Clock::time_point t0;                                  ///< Entry time.
+    Clock::time_point t1;                                  ///< Exit time.
+    std::int64_t child_ns;                                 ///< Time spent in nested calls.
+};
+
+/// @brief Calls recorded by one thread; owned by the registry so it outlives the thread.
+///
+/// When its thread exits the buffer is retired; once its calls are collected (or
+/// cleared) it is reused by the next thread that makes an instrumented call.
+struct ThreadBuffer {
+    bool in_use;                                           ///< Whether a live thread writes into it.
+    std::vector<Frame> stack;                              ///< Open calls, innermost last.
+    std::vector<Call> calls;                               ///< Completed calls.
+};
+
+/// @brief Retires this thread's buffer when the thread exits.
+struct Release {
+    JAMANAK_NO_INSTRUMENT ~Release();
+};
+
+std::atomic<bool> recording{true};                         ///< Global on/off switch.
+std::mutex registry_mutex;                                 ///< Guards buffers.
+std::vector<ThreadBuffer*> buffers;                        ///< Every buffer, live, retired or free.
+
+thread_local ThreadBuffer* local = nullptr;                ///< This thread's buffer (trivially destructible on purpose).
+thread_local bool in_hook = false;                         ///< Guards against re-entering the hooks.
+thread_local bool exiting = false;                         ///< Set once the thread's buffer has been retired.
+thread_local Release release;                              ///< Retires `local` at thread exit.
+
+Release::~Release() {
+    if (!local) return;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    local->in_use = false;
+    local->stack.clear();
+    local = nullptr;
+    exiting = true;
+}
+
+/// @brief Returns this thread's buffer, taking a drained retired one or registering a new one on first use.
+JAMANAK_NO_INSTRUMENT ThreadBuffer* buffer() {
+    if (local) return local;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    (void)&release;  // odr-use, so the destructor is registered for this thread
+    for (auto* b : buffers) {
+        if (!b->in_use && b->calls.empty()) {
+            b->in_use = true;
+            return local = b;
+        }
+    }
+    local = new ThreadBuffer{true, {}, {}};
+    local->stack.reserve(64);
+    local->calls.reserve(4096);
+    buffers.push_back(local);
+    return local;
+}
+
+/// @brief Returns the demangled name of the function at @p fn, or its address.
+JAMANAK_NO_INSTRUMENT std::string symbol(void* fn) {
+    Dl_info info;
+    if (dladdr(fn, &info) && info.dli_sname) {
+        int status = 0;
+        char* name = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string out = status == 0 && name ? name : info.dli_sname;
+        std::free(name);
+        return out;
+    }
+
+    char hex[2 + 2 * sizeof(void*) + 1];
+    std::snprintf(hex, sizeof(hex), "%p", fn);
+    return hex;
+}
+
+} // namespace
+
+void enable() { recording.store(true, std::memory_order_relaxed); }
+
+void disable() { recording.store(false, std::memory_order_relaxed); }
+
+bool enabled() { return recording.load(std::memory_order_relaxed); }
+
+size_t collect(Jamanak& profiler, Timing timing) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::unordered_map<void*, std::string> names;
+    size_t n = 0;
+
+    // The calling thread is lane 0; the others are numbered per collect, by first call.
+    std::vector<ThreadBuffer*> order;
+    for (auto* b : buffers) {
+        if (b != local && !b->calls.empty()) order.push_back(b);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const ThreadBuffer* a, const ThreadBuffer* b) { return a->calls.front().t0 < b->calls.front().t0; });
+    if (local) order.insert(order.begin(), local);
+
+    for (size_t lane = 0; lane < order.size(); ++lane) {
+        auto* b = order[lane];
+        for (const auto& c : b->calls) {
+            auto it = names.find(c.fn);
+            if (it == names.end()) it = names.emplace(c.fn, symbol(c.fn)).first;
+
+            auto t1 = c.t1;
+            if (timing == Timing::self) t1 -= std::chrono::nanoseconds(c.child_ns);
+            profiler.record(it->second, c.t0, t1, local ? lane : lane + 1);
+        }
+        n += b->calls.size();
+        b->calls.clear();
+    }
+
+    return n;
+}
+
+void clear() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto* b : buffers) b->calls.clear();
+}
+
+} // namespace instrument
+} // namespace jamanak
+
+using namespace jamanak::instrument;
+
+extern "C" {
+
+JAMANAK_NO_INSTRUMENT void __cyg_profile_func_enter(void* fn, void* /*call_site*/) {
+    if (in_hook || exiting || !recording.load(std::memory_order_relaxed)) return;
+    in_hook = true;
+    auto* b = buffer();
+    b->stack.push_back({fn, {}, 0});
+    b->stack.back().t0 = jamanak::Clock::now();
+    in_hook = false;
+}
+
+JAMANAK_NO_INSTRUMENT void __cyg_profile_func_exit(void* fn, void* /*call_site*/) {
+    auto t1 = jamanak::Clock::now();
+    if (in_hook || !local || local->stack.empty() || local->stack.back().fn != fn) return;
+    in_hook = true;
+
+    const Frame f = local->stack.back();
+    local->stack.pop_back();
+    local->calls.push_back({f.fn, f.t0, t1, f.child_ns});
+    if (!local->stack.empty()) {
+        local->stack.back().child_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - f.t0).count();
+    }
+
+    in_hook = false;
+}
+
+} // extern "C"
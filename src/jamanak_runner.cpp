@@ -0,0 +1,1461 @@
+/// @file jamanak_runner.cpp
+/// @brief Benchmark runners built on Jamanak epochs.
+
+#include "jamanak_runner.hpp"
+#include "jamanak_format.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define JAMANAK_HAS_FORK 1
+#include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace jamanak {
+
+using namespace format_detail;
+
+namespace {
+
+/// @brief Returns g(n) of @p complexity.
+double growth(Complexity complexity, double n) {
+    switch (complexity) {
+        case Complexity::o_log_n:   return std::log2(n);
+        case Complexity::o_n:       return n;
+        case Complexity::o_n_log_n: return n * std::log2(n);
+        case Complexity::o_n2:      return n * n;
+        default:                    return 1.0;
+    }
+}
+
+/// @brief A table row collected as plain text (for widths) and ANSI text (for output).
+struct Row {
+    std::string plain;                                     ///< Visible text.
+    std::string ansi;                                      ///< Text with color escapes.
+
+    /// @brief Appends @p text, wrapped in @p color unless it is empty.
+    Row& add(const std::string& text, const char* color = "") {
+        plain += text;
+        ansi += *color ? std::string(color) + text + ANSI_RESET : text;
+        return *this;
+    }
+};
+
+/// @brief Pins the calling thread to @p cpu (modulo the CPU count); no-op outside Linux.
+/// @return Whether the affinity was set.
+bool pin_to(size_t cpu) {
+#ifdef __linux__
+    const size_t n = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<int>(cpu % n), &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+/// @brief Renders @p hdr and @p sections of rows as a framed table, sections separated by fences.
+std::string table(const std::string& hdr, const std::vector<std::vector<Row>>& sections) {
+    size_t l_body{0};
+    for (const auto& rows : sections) {
+        for (const auto& r : rows) l_body = std::max(l_body, text_width(r.plain));
+    }
+    const size_t l_size = std::max(l_body + 6, text_width(hdr) + 4);
+    const size_t sf_size = l_size / 2 > text_width(hdr) / 2 ? l_size / 2 - text_width(hdr) / 2 : 0;
+
+    std::ostringstream out;
+    out << ANSI_BOLD << ANSI_RGB(227,225,127);
+    out << fence(l_size, "–") << "\n";
+    out << fence(sf_size, " ") << hdr << "\n";
+    out << fence(l_size, "–") << ANSI_RESET << "\n";
+
+    for (const auto& rows : sections) {
+        for (const auto& r : rows) {
+            out << ANSI_BOLD << ANSI_RGB(227,225,127) << "|| " << ANSI_RESET;
+            out << r.ansi << fence(l_size - 6 - text_width(r.plain), " ");
+            out << ANSI_BOLD << ANSI_RGB(227,225,127) << " ||" << ANSI_RESET << "\n";
+        }
+        out << ANSI_BOLD << ANSI_RGB(227,225,127) << fence(l_size, "–") << ANSI_RESET << "\n";
+    }
+
+    return out.str();
+}
+
+/// @brief Returns the standard normal quantile of @p p (Acklam's rational approximation).
+double normal_quantile(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+
+    p = std::min(std::max(p, 1e-12), 1.0 - 1e-12);
+    if (p < 0.02425 || p > 0.97575) {
+        const double q = std::sqrt(-2.0 * std::log(p < 0.5 ? p : 1.0 - p));
+        const double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                         ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+        return p < 0.5 ? x : -x;
+    }
+    const double q = p - 0.5, r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+/// @brief Returns the two-sided Student t critical value for @p confidence and @p df degrees of freedom.
+///
+/// Cornish-Fisher expansion around the normal quantile; within 1% of the exact value for df >= 3.
+double t_critical(double confidence, double df) {
+    const double z = normal_quantile(0.5 + confidence / 2.0);
+    if (df <= 0.0) return z;
+    const double z3 = z * z * z, z5 = z3 * z * z, z7 = z5 * z * z;
+    return z + (z3 + z) / (4.0 * df) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * df * df) +
+           (3.0 * z7 + 19.0 * z5 + 17.0 * z3 - 15.0 * z) / (384.0 * df * df * df);
+}
+
+/// @brief Returns the mean and the sample variance of @p xs.
+std::pair<double, double> mean_var(const std::vector<double>& xs) {
+    if (xs.empty()) return {0.0, 0.0};
+    double mean = 0.0, m2 = 0.0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        const double d = xs[i] - mean;
+        mean += d / static_cast<double>(i + 1);
+        m2   += d * (xs[i] - mean);
+    }
+    return {mean, xs.size() > 1 ? m2 / static_cast<double>(xs.size() - 1) : 0.0};
+}
+
+#ifdef JAMANAK_HAS_FORK
+/// @brief Message tags of the child-to-parent pipe protocol of isolated cases.
+enum Message : char {
+    msg_label = 'L',  ///< u32 length, then the label bytes; ids are assigned in order.
+    msg_epoch = 'E',  ///< i64 begin, i64 end, u32 jam count, then per jam: u32 label, u32 thread, i64 t0, i64 t1, u64 items, u64 bytes.
+};
+
+/// @brief Appends the bytes of @p v to @p out.
+template <typename T>
+void put(std::string& out, T v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+/// @brief Reads a @p T at @p pos of @p in and advances @p pos.
+/// @return false if fewer than sizeof(T) bytes are left.
+template <typename T>
+bool get(const std::string& in, size_t& pos, T& v) {
+    if (in.size() - pos < sizeof(T)) return false;
+    std::memcpy(&v, in.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+/// @brief Writes all of @p data to @p fd, retrying on EINTR and partial writes.
+bool write_all(int fd, const std::string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        const ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/// @brief Body of an isolated child: runs the case and streams every recorded epoch to @p fd.
+[[noreturn]] void run_child(const Case& c, const InterleaveOptions& opts, int fd) {
+    try {
+        Jamanak profiler(c.name);
+        std::unordered_map<std::string, std::uint32_t> ids;
+        for (size_t round = 0; round < opts.warmup + opts.rounds; ++round) {
+            profiler.begin_epoch();
+            const auto t0 = Clock::now();
+            c.epoch(profiler);
+            const auto t1 = Clock::now();
+            const auto jams = profiler.get_jams();
+            profiler.clean_jams();
+            if (round < opts.warmup) continue;
+
+            std::string msg;
+            for (const auto& j : jams) {
+                if (ids.count(j.context)) continue;
+                ids.emplace(j.context, static_cast<std::uint32_t>(ids.size()));
+                put(msg, msg_label);
+                put(msg, static_cast<std::uint32_t>(j.context.size()));
+                msg += j.context;
+            }
+            put(msg, msg_epoch);
+            put(msg, static_cast<std::int64_t>(t0.time_since_epoch().count()));
+            put(msg, static_cast<std::int64_t>(t1.time_since_epoch().count()));
+            put(msg, static_cast<std::uint32_t>(jams.size()));
+            for (const auto& j : jams) {
+                put(msg, ids[j.context]);
+                put(msg, static_cast<std::uint32_t>(j.thread));
+                put(msg, static_cast<std::int64_t>(j.t0.time_since_epoch().count()));
+                put(msg, static_cast<std::int64_t>(j.t1.time_since_epoch().count()));
+                put(msg, static_cast<std::uint64_t>(j.items));
+                put(msg, static_cast<std::uint64_t>(j.bytes));
+            }
+            if (!write_all(fd, msg)) _exit(3);
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "jamanak: case '%s' threw: %s\n", c.name.c_str(), e.what());
+        _exit(2);
+    } catch (...) {
+        _exit(2);
+    }
+    _exit(0);
+}
+
+/// @brief Decodes the messages of an isolated child into @p r's profiler and samples.
+void import_child(const std::string& in, CaseResult& r) {
+    std::vector<std::string> labels;
+    size_t pos = 0;
+    char tag;
+    while (get(in, pos, tag)) {
+        if (tag == msg_label) {
+            std::uint32_t len;
+            if (!get(in, pos, len) || in.size() - pos < len) return;
+            labels.push_back(in.substr(pos, len));
+            pos += len;
+            continue;
+        }
+
+        std::int64_t b, e;
+        std::uint32_t n;
+        if (tag != msg_epoch || !get(in, pos, b) || !get(in, pos, e) || !get(in, pos, n)) return;
+        std::vector<Jam> jams(n);
+        for (auto& j : jams) {
+            std::uint32_t label, thread;
+            std::int64_t t0, t1;
+            std::uint64_t items, bytes;
+            if (!get(in, pos, label) || !get(in, pos, thread) || !get(in, pos, t0) || !get(in, pos, t1) ||
+                !get(in, pos, items) || !get(in, pos, bytes) || label >= labels.size()) return;
+            j.context = labels[label];
+            j.thread  = thread;
+            j.t0      = Clock::time_point(Clock::duration(t0));
+            j.t1      = Clock::time_point(Clock::duration(t1));
+            j.items   = items;
+            j.bytes   = bytes;
+        }
+        r.profiler.import_epoch(jams, Clock::time_point(Clock::duration(b)), Clock::time_point(Clock::duration(e)));
+        r.samples.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                Clock::duration(e) - Clock::duration(b)).count()));
+    }
+}
+
+/// @brief Runs @p c in a forked child, collecting its epochs into @p r and its failure into r.error.
+void run_isolated(const Case& c, const InterleaveOptions& opts, CaseResult& r) {
+    int fds[2];
+    if (pipe(fds) != 0) throw std::runtime_error("cannot create pipe for isolated case");
+    std::fflush(nullptr);
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        throw std::runtime_error("cannot fork isolated case");
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        run_child(c, opts, fds[1]);
+    }
+    close(fds[1]);
+
+    // Read until EOF, so a child writing more than the pipe buffer never blocks.
+    std::string in;
+    bool timed_out = false;
+    const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(opts.timeout_s));
+    char buf[1 << 16];
+    for (;;) {
+        int wait_ms = -1;
+        if (opts.timeout_s > 0.0) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            if (left <= 0) { timed_out = true; break; }
+            wait_ms = static_cast<int>(std::min<long long>(left, 1 << 30));
+        }
+        pollfd p{fds[0], POLLIN, 0};
+        const int ready = poll(&p, 1, wait_ms);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready == 0) { timed_out = true; break; }
+        const ssize_t n = read(fds[0], buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        in.append(buf, static_cast<size_t>(n));
+    }
+    if (timed_out) kill(pid, SIGKILL);
+    close(fds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+
+    import_child(in, r);
+    if (timed_out) {
+        std::ostringstream e;
+        e << "timed out after " << opts.timeout_s << " s";
+        r.error = e.str();
+    } else if (WIFSIGNALED(status)) {
+        r.error = std::string("killed by signal ") + std::to_string(WTERMSIG(status)) + " (" + strsignal(WTERMSIG(status)) + ")";
+    } else if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+        r.error = "exited with status " + std::to_string(WEXITSTATUS(status));
+    }
+}
+#endif
+
+/// @brief Formats a per-unit coefficient with 4 significant digits in a fitting time unit.
+std::string coefficient(double ns) {
+    const Unit unit = pick_unit(std::fabs(ns), Unit::automatic);
+    std::ostringstream ss;
+    ss << std::setprecision(4) << ns / unit_ns(unit) << " " << unit_suffix(unit);
+    return ss.str();
+}
+
+} // namespace
+
+std::vector<size_t> pow2_sizes(size_t lo, size_t hi) {
+    std::vector<size_t> out;
+    for (size_t n = std::max<size_t>(lo, 1); n <= hi && n != 0; n *= 2) out.push_back(n);
+    return out;
+}
+
+const char* complexity_name(Complexity complexity) {
+    switch (complexity) {
+        case Complexity::o_log_n:   return "O(log n)";
+        case Complexity::o_n:       return "O(n)";
+        case Complexity::o_n_log_n: return "O(n log n)";
+        case Complexity::o_n2:      return "O(n²)";
+        default:                    return "O(1)";
+    }
+}
+
+ComplexityFit fit(const std::vector<SweepPoint>& points, Complexity complexity) {
+    ComplexityFit out;
+    out.complexity = complexity;
+
+    // Minimizes the squared relative residuals, so small sizes weigh as much as large ones.
+    double num = 0.0, den = 0.0;
+    size_t k = 0;
+    for (const auto& p : points) {
+        if (p.mean_ns <= 0.0) continue;
+        const double g = growth(complexity, static_cast<double>(p.n)) / p.mean_ns;
+        num += g;
+        den += g * g;
+        ++k;
+    }
+    if (k == 0) return out;
+    out.coefficient = den > 0.0 ? num / den : 0.0;
+
+    double sq = 0.0;
+    for (const auto& p : points) {
+        if (p.mean_ns <= 0.0) continue;
+        const double r = 1.0 - out.coefficient * growth(complexity, static_cast<double>(p.n)) / p.mean_ns;
+        sq += r * r;
+    }
+    out.rms = std::sqrt(sq / static_cast<double>(k));
+
+    return out;
+}
+
+SweepResult sweep(Jamanak& profiler, const std::string& name, const std::vector<size_t>& sizes, size_t reps,
+                  const std::function<void(size_t)>& fn,
+                  const std::function<void(size_t)>& setup) {
+    if (sizes.empty() || reps == 0) throw std::runtime_error("sweep needs at least one size and one run");
+
+    std::vector<size_t> ns = sizes;
+    std::sort(ns.begin(), ns.end());
+    ns.erase(std::unique(ns.begin(), ns.end()), ns.end());
+
+    std::vector<std::string> labels;
+    for (size_t n : ns) {
+        labels.push_back(name + " n=" + std::to_string(n));
+        if (setup) setup(n);
+
+        for (size_t r = 0; r < reps; ++r) {
+            profiler.begin_epoch();
+            profiler.start(labels.back());
+            fn(n);
+            profiler.stop(n);
+            profiler.end_epoch();
+        }
+    }
+
+    SweepResult result;
+    result.name = name;
+    const auto stats = profiler.label_stats();
+    for (size_t i = 0; i < ns.size(); ++i) {
+        for (const auto& st : stats) {
+            if (st.context != labels[i]) continue;
+            result.points.push_back({ns[i], st.mean_ns, st.stddev_ns});
+            break;
+        }
+    }
+
+    for (auto c : {Complexity::o_1, Complexity::o_log_n, Complexity::o_n, Complexity::o_n_log_n, Complexity::o_n2}) {
+        result.fits.push_back(fit(result.points, c));
+    }
+    std::stable_sort(result.fits.begin(), result.fits.end(),
+                     [](const ComplexityFit& a, const ComplexityFit& b) { return a.rms < b.rms; });
+
+    return result;
+}
+
+std::string to_string(const SweepResult& result, Unit unit) {
+    if (result.points.empty()) return "";
+
+    double slowest = 0.0;
+    for (const auto& p : result.points) slowest = std::max(slowest, p.mean_ns);
+    unit = pick_unit(slowest, unit);
+    const std::string suffix = std::string(" ") + unit_suffix(unit);
+
+    size_t l_n{0}, l_bc{0}, l_frac{0}, l_sd{0};
+    std::vector<std::string> n_strs, mean_strs, sd_strs;
+    for (const auto& p : result.points) {
+        n_strs.push_back("n=" + std::to_string(p.n));
+        mean_strs.push_back(format(p.mean_ns, unit));
+        sd_strs.push_back(format(p.stddev_ns, unit));
+        l_n    = std::max(l_n, n_strs.back().size());
+        l_bc   = std::max(l_bc, get_shift(mean_strs.back()));
+        l_frac = std::max(l_frac, mean_strs.back().size() - get_shift(mean_strs.back()));
+        l_sd   = std::max(l_sd, sd_strs.back().size());
+    }
+
+    std::vector<Row> rows;
+    for (size_t i = 0; i < result.points.size(); ++i) {
+        Row r;
+        r.add(n_strs[i], ANSI_BOLD ANSI_RGB(143,227,125));
+        r.add(fence(l_n - n_strs[i].size() + 2, "–") + ": ");
+        r.add(fence(l_bc - get_shift(mean_strs[i]), " ") + mean_strs[i], ANSI_BOLD ANSI_RGB(143,227,125));
+        r.add(suffix + fence(l_frac - (mean_strs[i].size() - get_shift(mean_strs[i])), " "));
+        r.add("  ± " + fence(l_sd - sd_strs[i].size(), " ") + sd_strs[i], ANSI_DIM);
+        rows.push_back(r);
+    }
+
+    size_t l_cls{0}, l_coef{0};
+    std::vector<std::string> coef_strs;
+    for (const auto& f : result.fits) {
+        coef_strs.push_back(coefficient(f.coefficient));
+        l_cls  = std::max(l_cls, text_width(complexity_name(f.complexity)));
+        l_coef = std::max(l_coef, text_width(coef_strs.back()));
+    }
+
+    std::vector<Row> fits;
+    for (size_t i = 0; i < result.fits.size(); ++i) {
+        const auto& f = result.fits[i];
+        const std::string cls = complexity_name(f.complexity);
+        std::ostringstream rms;
+        rms << std::fixed << std::setprecision(1) << f.rms * 100.0 << "%";
+
+        Row r;
+        r.add(cls, i == 0 ? ANSI_BOLD ANSI_RGB(143,227,125) : ANSI_DIM);
+        r.add(fence(l_cls - text_width(cls) + 1, " ") + ": ");
+        r.add(fence(l_coef - text_width(coef_strs[i]), " ") + coef_strs[i], i == 0 ? ANSI_BOLD ANSI_RGB(143,227,125) : "");
+        r.add(" · g(n)  rms ");
+        r.add(rms.str(), i == 0 ? ANSI_BOLD ANSI_RGB(143,227,125) : ANSI_DIM);
+        if (i == 0) r.add("  best");
+        fits.push_back(r);
+    }
+
+    return table(result.name + "  [complexity sweep]", {rows, fits});
+}
+
+double serial_fraction(const std::vector<ScalingPoint>& points) {
+    // Amdahl: 1/S - 1/p = f (1 - 1/p).
+    double xy = 0.0, xx = 0.0;
+    for (const auto& p : points) {
+        if (p.threads <= 1 || !(p.speedup > 0.0)) continue;
+        const double x = 1.0 - 1.0 / static_cast<double>(p.threads);
+        xy += x * (1.0 / p.speedup - 1.0 / static_cast<double>(p.threads));
+        xx += x * x;
+    }
+    return xx > 0.0 ? std::min(1.0, std::max(0.0, xy / xx)) : 0.0;
+}
+
+ScalingResult scale(Jamanak& profiler, const std::string& name,
+                    const std::function<void(Lane&, size_t, size_t)>& workload,
+                    const ScalingOptions& opts) {
+    const size_t max_threads = opts.max_threads ? opts.max_threads
+                                                : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+
+    // Per label and thread count: summed work and summed span over the repetitions.
+    struct Acc { double work{0.0}, span{0.0}; bool items{false}; };
+    std::vector<std::string> labels;
+    std::vector<std::vector<Acc>> acc;
+
+    for (size_t c = 0; c < counts.size(); ++c) {
+        const size_t threads = counts[c];
+        for (size_t r = 0; r < std::max<size_t>(opts.reps, 1); ++r) {
+            profiler.begin_epoch();
+            std::vector<Lane> lanes;
+            for (size_t t = 0; t < threads; ++t) lanes.push_back(profiler.fork());
+
+            std::atomic<size_t> ready{0};
+            std::atomic<bool> go{false};
+            std::vector<std::thread> pool;
+            for (size_t t = 0; t < threads; ++t) {
+                pool.emplace_back([&, t] {
+                    if (opts.pin) pin_to(t);
+                    ready.fetch_add(1);
+                    while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                    workload(lanes[t], t, threads);
+                });
+            }
+            while (ready.load() < threads) std::this_thread::yield();
+            go.store(true, std::memory_order_release);
+            for (auto& th : pool) th.join();
+            for (auto& lane : lanes) profiler.join(lane);
+
+            // Span and work per label in this epoch.
+            std::vector<Clock::time_point> first, last;
+            std::vector<double> work;
+            std::vector<bool> items;
+            std::vector<size_t> index;
+            for (const auto& j : profiler.get_jams()) {
+                size_t l = std::find(labels.begin(), labels.end(), j.context) - labels.begin();
+                if (l == labels.size()) {
+                    labels.push_back(j.context);
+                    acc.emplace_back(counts.size());
+                }
+                size_t k = std::find(index.begin(), index.end(), l) - index.begin();
+                if (k == index.size()) {
+                    index.push_back(l);
+                    first.push_back(j.t0);
+                    last.push_back(j.t1);
+                    work.push_back(0.0);
+                    items.push_back(false);
+                }
+                first[k] = std::min(first[k], j.t0);
+                last[k]  = std::max(last[k], j.t1);
+                work[k] += j.items ? static_cast<double>(j.items) : 1.0;
+                items[k] = items[k] || j.items;
+            }
+            for (size_t k = 0; k < index.size(); ++k) {
+                auto& a = acc[index[k]][c];
+                a.work  += work[k];
+                a.span  += static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(last[k] - first[k]).count());
+                a.items  = a.items || items[k];
+            }
+            profiler.end_epoch();
+        }
+    }
+
+    ScalingResult result;
+    result.name = name;
+    for (size_t l = 0; l < labels.size(); ++l) {
+        ScalingLabel sl;
+        sl.context = labels[l];
+        double base = 0.0;
+        for (size_t c = 0; c < counts.size(); ++c) {
+            const auto& a = acc[l][c];
+            if (a.span <= 0.0) continue;
+            ScalingPoint p;
+            p.threads = counts[c];
+            p.span_ns = a.span / static_cast<double>(std::max<size_t>(opts.reps, 1));
+            p.per_s   = a.work / a.span * 1e9;
+            if (base == 0.0) base = p.per_s;
+            p.speedup    = base > 0.0 ? p.per_s / base : 0.0;
+            p.efficiency = p.speedup / static_cast<double>(p.threads);
+            sl.items = sl.items || a.items;
+            sl.points.push_back(p);
+        }
+        sl.serial_fraction = serial_fraction(sl.points);
+        result.labels.push_back(sl);
+    }
+
+    return result;
+}
+
+std::string to_string(const ScalingResult& result) {
+    if (result.labels.empty()) return "";
+
+    size_t l_ctx{0}, l_t{7}, l_rate{7}, l_sp{7};
+    std::vector<std::vector<std::string>> rates(result.labels.size()), speedups(result.labels.size());
+    for (size_t l = 0; l < result.labels.size(); ++l) {
+        const auto& sl = result.labels[l];
+        l_ctx = std::max(l_ctx, text_width(sl.context));
+        for (const auto& p : sl.points) {
+            std::ostringstream sp;
+            sp << std::fixed << std::setprecision(2) << p.speedup << "x";
+            rates[l].push_back(sl.items ? items_rate(p.per_s) : scaled(p.per_s, false) + "jams/s");
+            speedups[l].push_back(sp.str());
+            l_t    = std::max(l_t, std::to_string(p.threads).size());
+            l_rate = std::max(l_rate, text_width(rates[l].back()));
+            l_sp   = std::max(l_sp, speedups[l].back().size());
+        }
+    }
+
+    auto pad = [](const std::string& s, size_t w) { return fence(w - text_width(s), " ") + s; };
+
+    std::vector<std::vector<Row>> sections;
+    Row head;
+    head.add(fence(l_ctx + 4, " ") + pad("threads", l_t) + "  " + pad("work/s", l_rate) + "  " +
+             pad("speedup", l_sp) + "  efficiency", ANSI_DIM);
+    sections.push_back({head});
+
+    for (size_t l = 0; l < result.labels.size(); ++l) {
+        const auto& sl = result.labels[l];
+        std::vector<Row> rows;
+        for (size_t i = 0; i < sl.points.size(); ++i) {
+            const auto& p = sl.points[i];
+            std::ostringstream eff;
+            eff << std::fixed << std::setprecision(1) << p.efficiency * 100.0 << "%";
+
+            Row r;
+            if (i == 0) {
+                r.add(sl.context, ANSI_BOLD ANSI_RGB(143,227,125));
+                r.add(fence(l_ctx - text_width(sl.context) + 2, "–") + ": ");
+            } else {
+                r.add(fence(l_ctx + 4, " "));
+            }
+            r.add(pad(std::to_string(p.threads), l_t) + "  ");
+            r.add(pad(rates[l][i], l_rate), ANSI_BOLD ANSI_RGB(143,227,125));
+            r.add("  " + pad(speedups[l][i], l_sp) + "  ");
+            r.add(pad(eff.str(), 10), p.efficiency < 0.5 ? ANSI_BOLD ANSI_RGB(227,143,125) : "");
+            rows.push_back(r);
+        }
+
+        std::ostringstream f;
+        f << std::fixed << std::setprecision(1) << sl.serial_fraction * 100.0 << "%";
+        Row r;
+        r.add(fence(l_ctx + 4, " ") + "serial fraction ", ANSI_DIM);
+        r.add(f.str(), ANSI_BOLD ANSI_RGB(143,227,125));
+        rows.push_back(r);
+        sections.push_back(rows);
+    }
+
+    return table(result.name + "  [thread scaling]", sections);
+}
+
+size_t last_level_cache_bytes() {
+    size_t best = 0;
+    int best_level = 0;
+    for (int i = 0; i < 16; ++i) {
+        const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(i);
+        std::ifstream level_in(dir + "/level"), type_in(dir + "/type"), size_in(dir + "/size");
+        if (!level_in || !size_in) break;
+
+        int level = 0;
+        std::string type, size;
+        level_in >> level;
+        type_in >> type;
+        size_in >> size;
+        if (type == "Instruction" || size.empty()) continue;
+
+        size_t bytes = std::strtoull(size.c_str(), nullptr, 10);
+        switch (size.back()) {
+            case 'K': bytes <<= 10; break;
+            case 'M': bytes <<= 20; break;
+            case 'G': bytes <<= 30; break;
+            default: break;
+        }
+        if (level > best_level || (level == best_level && bytes > best)) {
+            best_level = level;
+            best = bytes;
+        }
+    }
+
+#if defined(__linux__) && defined(_SC_LEVEL3_CACHE_SIZE)
+    if (!best) {
+        for (int name : {_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE}) {
+            const long bytes = sysconf(name);
+            if (bytes > 0) { best = static_cast<size_t>(bytes); break; }
+        }
+    }
+#endif
+
+    return best ? best : size_t(32) << 20;
+}
+
+void evict_caches(size_t bytes) {
+    static std::vector<std::uint64_t> buffer;
+
+    if (!bytes) bytes = 2 * last_level_cache_bytes();
+    const size_t words = bytes / sizeof(std::uint64_t);
+    if (buffer.size() < words) buffer.resize(words, 0);
+
+    // One read-modify-write per 64-byte line pulls the line in and leaves it dirty,
+    // so the previous contents of every cache level are displaced.
+    for (size_t i = 0; i < words; i += 64 / sizeof(std::uint64_t)) ++buffer[i];
+}
+
+bool flush_caches(const void* data, size_t bytes) {
+#if defined(__x86_64__) || defined(__i386__)
+    const auto* p = static_cast<const char*>(data);
+    const auto* first = reinterpret_cast<const char*>(reinterpret_cast<std::uintptr_t>(p) & ~std::uintptr_t(63));
+    for (const char* line = first; line < p + bytes; line += 64) _mm_clflush(line);
+    _mm_mfence();
+    return true;
+#else
+    (void)data;
+    (void)bytes;
+    return false;
+#endif
+}
+
+CacheResult cold_warm(const std::string& name, const std::function<void(Jamanak&)>& epoch,
+                      const CacheOptions& opts) {
+    if (opts.eviction == Eviction::evict_flush && opts.flush.empty()) {
+        throw std::runtime_error("flush eviction needs at least one buffer");
+    }
+
+    CacheResult result;
+    result.name = name;
+    result.eviction = opts.eviction;
+    if (result.eviction == Eviction::evict_flush && !flush_caches(opts.flush.front().first, 0)) {
+        result.eviction = Eviction::evict_stream;
+    }
+    if (result.eviction == Eviction::evict_stream) {
+        result.evict_bytes = opts.evict_bytes ? opts.evict_bytes : 2 * last_level_cache_bytes();
+    }
+
+    Jamanak cold(name + " cold"), warm(name + " warm");
+    for (size_t r = 0; r < std::max<size_t>(opts.reps, 1); ++r) {
+        if (result.eviction == Eviction::evict_flush) {
+            for (const auto& b : opts.flush) flush_caches(b.first, b.second);
+        } else {
+            evict_caches(result.evict_bytes);
+        }
+
+        cold.begin_epoch();
+        epoch(cold);
+        cold.end_epoch();
+
+        warm.begin_epoch();
+        epoch(warm);
+        warm.end_epoch();
+    }
+
+    const auto cold_stats = cold.label_stats();
+    const auto warm_stats = warm.label_stats();
+    for (const auto& c : cold_stats) {
+        CacheLabel l;
+        l.context = c.context;
+        l.cold = c;
+        for (const auto& w : warm_stats) {
+            if (w.context == c.context) { l.warm = w; break; }
+        }
+        result.labels.push_back(l);
+    }
+
+    return result;
+}
+
+std::string to_string(const CacheResult& result, Unit unit) {
+    if (result.labels.empty()) return "";
+
+    double slowest = 0.0;
+    for (const auto& l : result.labels) slowest = std::max(slowest, l.cold.mean_ns);
+    unit = pick_unit(slowest, unit);
+    const std::string suffix = std::string(" ") + unit_suffix(unit);
+
+    size_t l_ctx{0}, l_cold{4}, l_warm{4};
+    std::vector<std::string> cold_strs, warm_strs;
+    for (const auto& l : result.labels) {
+        cold_strs.push_back(format(l.cold.mean_ns, unit) + suffix);
+        warm_strs.push_back(format(l.warm.mean_ns, unit) + suffix);
+        l_ctx  = std::max(l_ctx, text_width(l.context));
+        l_cold = std::max(l_cold, text_width(cold_strs.back()));
+        l_warm = std::max(l_warm, text_width(warm_strs.back()));
+    }
+
+    auto pad = [](const std::string& s, size_t w) { return fence(w - text_width(s), " ") + s; };
+
+    Row head;
+    head.add(fence(l_ctx + 4, " ") + pad("cold", l_cold) + "  " + pad("warm", l_warm) + "  cold/warm", ANSI_DIM);
+
+    std::vector<Row> rows;
+    for (size_t i = 0; i < result.labels.size(); ++i) {
+        const auto& l = result.labels[i];
+        std::ostringstream ratio;
+        ratio << std::fixed << std::setprecision(2) << (l.warm.mean_ns > 0.0 ? l.cold.mean_ns / l.warm.mean_ns : 0.0) << "x";
+
+        Row r;
+        r.add(l.context, ANSI_BOLD ANSI_RGB(143,227,125));
+        r.add(fence(l_ctx - text_width(l.context) + 2, "–") + ": ");
+        r.add(pad(cold_strs[i], l_cold), ANSI_BOLD ANSI_RGB(227,143,125));
+        r.add("  ");
+        r.add(pad(warm_strs[i], l_warm), ANSI_BOLD ANSI_RGB(143,227,125));
+        r.add("  " + pad(ratio.str(), 9));
+        rows.push_back(r);
+    }
+
+    std::string how = result.eviction == Eviction::evict_flush
+                    ? "clflush"
+                    : "stream " + scaled(static_cast<double>(result.evict_bytes), true) + "B";
+    return table(result.name + "  [cold vs warm · " + how + "]", {{head}, rows});
+}
+
+InterleaveResult interleave(const std::vector<Case>& cases, const InterleaveOptions& opts) {
+    if (cases.empty()) throw std::runtime_error("interleave needs at least one case");
+
+    InterleaveResult result;
+    result.seed = opts.seed;
+    result.confidence = opts.confidence;
+    result.isolated = opts.isolate;
+    for (const auto& c : cases) {
+        CaseResult r;
+        r.name = c.name;
+        r.profiler = Jamanak(c.name);
+        result.cases.push_back(std::move(r));
+    }
+
+    std::mt19937_64 rng(opts.seed);
+    std::vector<size_t> order(cases.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    if (opts.isolate) {
+#ifdef JAMANAK_HAS_FORK
+        for (size_t i = order.size(); i > 1; --i) std::swap(order[i - 1], order[rng() % i]);
+        for (size_t i : order) run_isolated(cases[i], opts, result.cases[i]);
+#else
+        throw std::runtime_error("process isolation needs fork()");
+#endif
+    }
+
+    for (size_t round = 0; !opts.isolate && round < opts.warmup + opts.rounds; ++round) {
+        // Fisher-Yates on the raw generator: std::shuffle's draws differ between standard libraries.
+        for (size_t i = order.size(); i > 1; --i) std::swap(order[i - 1], order[rng() % i]);
+
+        const bool recorded = round >= opts.warmup;
+        for (size_t i : order) {
+            auto& r = result.cases[i];
+            r.profiler.begin_epoch();
+            const auto t0 = Clock::now();
+            cases[i].epoch(r.profiler);
+            const auto t1 = Clock::now();
+            if (!recorded) {
+                r.profiler.clean_jams();
+                continue;
+            }
+            r.profiler.end_epoch();
+            r.samples.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+        }
+    }
+
+    const auto base = mean_var(result.cases.front().samples);
+    for (auto& r : result.cases) {
+        const auto mv = mean_var(r.samples);
+        const double n = static_cast<double>(r.samples.size());
+        r.mean_ns = mv.first;
+        r.ci_ns   = n > 1 ? t_critical(opts.confidence, n - 1.0) * std::sqrt(mv.second / n) : 0.0;
+        if (base.first <= 0.0) continue;
+
+        // Welch interval of the difference of means, expressed relative to the baseline mean.
+        const double nb = static_cast<double>(result.cases.front().samples.size());
+        const double va = mv.second / n, vb = base.second / nb;
+        const double se = std::sqrt(va + vb);
+        const double df = (va + vb) * (va + vb) /
+                          ((n > 1 ? va * va / (n - 1.0) : 0.0) + (nb > 1 ? vb * vb / (nb - 1.0) : 0.0) + 1e-300);
+        r.delta    = (mv.first - base.first) / base.first;
+        r.delta_ci = &r == &result.cases.front() ? 0.0 : t_critical(opts.confidence, df) * se / base.first;
+    }
+
+    return result;
+}
+
+std::string to_string(const InterleaveResult& result, Unit unit) {
+    if (result.cases.empty()) return "";
+
+    double slowest = 0.0;
+    for (const auto& c : result.cases) slowest = std::max(slowest, c.mean_ns);
+    unit = pick_unit(slowest, unit);
+    const std::string suffix = std::string(" ") + unit_suffix(unit);
+
+    size_t l_name{0}, l_mean{0}, l_ci{0}, l_delta{0};
+    std::vector<std::string> means, cis, deltas;
+    for (const auto& c : result.cases) {
+        std::ostringstream d;
+        d << std::fixed << std::setprecision(1) << std::showpos << c.delta * 100.0 << std::noshowpos
+          << "% ± " << c.delta_ci * 100.0 << "%";
+        means.push_back(format(c.mean_ns, unit) + suffix);
+        cis.push_back("± " + format(c.ci_ns, unit));
+        deltas.push_back(d.str());
+        l_name  = std::max(l_name, text_width(c.name));
+        l_mean  = std::max(l_mean, text_width(means.back()));
+        l_ci    = std::max(l_ci, text_width(cis.back()));
+        l_delta = std::max(l_delta, text_width(deltas.back()));
+    }
+
+    auto pad = [](const std::string& s, size_t w) { return fence(w - text_width(s), " ") + s; };
+
+    std::vector<Row> rows;
+    for (size_t i = 0; i < result.cases.size(); ++i) {
+        const auto& c = result.cases[i];
+        Row r;
+        r.add(c.name, ANSI_BOLD ANSI_RGB(143,227,125));
+        r.add(fence(l_name - text_width(c.name) + 2, "–") + ": ");
+        r.add(pad(means[i], l_mean), ANSI_BOLD ANSI_RGB(143,227,125));
+        r.add(" " + pad(cis[i], l_ci), ANSI_DIM);
+        if (!c.error.empty()) {
+            r.add("  " + c.error, ANSI_BOLD ANSI_RGB(227,143,125));
+        } else if (i == 0) {
+            r.add("  " + pad("baseline", l_delta), ANSI_DIM);
+        } else {
+            // Significant when the interval of the delta excludes zero.
+            const bool significant = std::fabs(c.delta) > c.delta_ci;
+            const char* color = !significant ? ANSI_DIM : c.delta > 0.0 ? ANSI_BOLD ANSI_RGB(227,143,125)
+                                                                         : ANSI_BOLD ANSI_RGB(143,227,125);
+            r.add("  ");
+            r.add(pad(deltas[i], l_delta), color);
+            r.add(!significant ? "  ~" : c.delta > 0.0 ? "  slower" : "  faster");
+        }
+        rows.push_back(r);
+    }
+
+    std::ostringstream foot;
+    foot << result.cases.front().samples.size() << (result.isolated ? " rounds, one process per case" : " interleaved rounds")
+         << " · seed " << result.seed
+         << " · " << static_cast<int>(std::lround(result.confidence * 100.0)) << "% CI";
+    Row f;
+    f.add(foot.str(), ANSI_DIM);
+
+    return table("comparison  [" + std::to_string(result.cases.size()) + " cases]", {rows, {f}});
+}
+
+SteadyResult run_until_steady(Jamanak& profiler, const std::function<void(Jamanak&)>& epoch, size_t samples,
+                              size_t max_epochs, const SteadyOptions& opts) {
+    SteadyResult result;
+    size_t k = profiler.epoch_count();
+    while (result.epochs < max_epochs) {
+        profiler.begin_epoch();
+        epoch(profiler);
+        profiler.end_epoch();
+        ++result.epochs;
+
+        // The first steady window never moves once found, so only look while none is known.
+        const size_t n = profiler.epoch_count();
+        if (k >= n || k + std::max<size_t>(opts.window, 2) > n) k = profiler.steady_epoch(opts);
+        if (k < n && n - k >= samples) {
+            result.dropped = profiler.drop_epochs(k);
+            result.steady = true;
+            break;
+        }
+    }
+    return result;
+}
+
+double LatencyHistogram::quantile(double q) const {
+    if (!n) return 0.0;
+    const auto rank = static_cast<std::uint64_t>(std::ceil(std::min(std::max(q, 0.0), 1.0) * static_cast<double>(n)));
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < buckets; ++i) {
+        seen += counts[i];
+        if (seen < std::max<std::uint64_t>(rank, 1)) continue;
+        const double lo = static_cast<double>(lower(i));
+        const double hi = i + 1 < buckets ? static_cast<double>(lower(i + 1)) : lo;
+        return std::min((lo + hi - 1.0) / 2.0, static_cast<double>(top));
+    }
+    return static_cast<double>(top);
+}
+
+std::uint64_t LatencyHistogram::count_above(std::int64_t ns) const {
+    if (ns < 0) return n;
+    std::uint64_t out = 0;
+    for (size_t i = index(static_cast<std::uint64_t>(ns)) + 1; i < buckets; ++i) out += counts[i];
+    return out;
+}
+
+LoadResult load(const std::string& name, const std::function<void(Jamanak&, std::uint64_t)>& fn,
+                const LoadOptions& opts) {
+    if (!(opts.rate > 0.0) || !(opts.duration_s > 0.0) || !opts.threads) {
+        throw std::runtime_error("load needs a positive rate, duration and thread count");
+    }
+
+    const auto total = static_cast<std::uint64_t>(opts.rate * opts.duration_s);
+    const double interval_ns = 1e9 / opts.rate;
+
+    // The schedule runs on the monotonic clock: a wall-clock step would shift every due time.
+    using Steady = std::chrono::steady_clock;
+    struct Worker {
+        Jamanak profiler{"load"};
+        LatencyHistogram latency;
+        LatencyHistogram service;
+        std::vector<LoadLabel> labels;
+        std::uint64_t late{0};
+        Steady::time_point last_end{};
+    };
+    std::vector<Worker> workers(opts.threads);
+
+    // Jams recorded by fn are folded into per-label histograms once `fold_at` are buffered,
+    // in the wait before a call; a worker with no slack folds at `fold_max`. Memory stays
+    // bounded by the buffer, not by rate × duration.
+    const size_t fold_at = 4096, fold_max = 4 * fold_at, slack = 64;
+    const auto fold = [](Worker& w) {
+        for (const auto& j : w.profiler.get_jams()) {
+            auto it = std::find_if(w.labels.begin(), w.labels.end(),
+                                   [&](const LoadLabel& l) { return l.context == j.context; });
+            if (it == w.labels.end()) {
+                w.labels.push_back({j.context, {}});
+                it = w.labels.end() - 1;
+            }
+            it->latency.record(j.duration_ns);
+        }
+        w.profiler.clean_jams();
+    };
+
+    // Room for the buffer up front; after the first call the reservation grows by the jams
+    // one call records, so the store never reallocates inside the timed loop.
+    for (auto& w : workers) w.profiler.reserve(fold_max + slack);
+
+    // Every worker waits for the common start so the schedule begins together.
+    const auto start = Steady::now() + std::chrono::milliseconds(10);
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < opts.threads; ++t) {
+        pool.emplace_back([&, t] {
+            auto& w = workers[t];
+            for (std::uint64_t k = t; k < total; k += opts.threads) {
+                const auto due = start + std::chrono::nanoseconds(static_cast<std::int64_t>(static_cast<double>(k) * interval_ns));
+                auto now = Steady::now();
+                const bool idle = now < due && due - now > std::chrono::microseconds(200);
+                if (w.profiler.jam_count() >= (idle ? fold_at : fold_max)) {
+                    fold(w);
+                    now = Steady::now();
+                }
+                if (now < due) {
+                    // Sleep most of the wait, spin the last stretch for an accurate start.
+                    if (due - now > std::chrono::microseconds(100)) std::this_thread::sleep_until(due - std::chrono::microseconds(50));
+                    while ((now = Steady::now()) < due) {}
+                } else if (now - due > std::chrono::microseconds(1)) {
+                    ++w.late;
+                }
+
+                fn(w.profiler, k);
+                const auto end = Steady::now();
+                w.latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - due).count());
+                w.service.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - now).count());
+                w.last_end = end;
+
+                if (k == t && w.profiler.jam_count() > 1) {
+                    w.profiler.reserve(fold_max + w.profiler.jam_count() + slack);
+                }
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    LoadResult result;
+    result.name = name;
+    result.target_rate = opts.rate;
+    result.calls = total;
+    result.labels.push_back({name, {}});
+
+    Steady::time_point last = start;
+    for (size_t t = 0; t < opts.threads; ++t) {
+        auto& w = workers[t];
+        result.labels.front().latency.merge(w.latency);
+        result.service.merge(w.service);
+        result.late += w.late;
+        last = std::max(last, w.last_end);
+
+        fold(w);
+        for (const auto& l : w.labels) {
+            auto it = std::find_if(result.labels.begin() + 1, result.labels.end(),
+                                   [&](const LoadLabel& r) { return r.context == l.context; });
+            if (it == result.labels.end()) result.labels.push_back(l);
+            else it->latency.merge(l.latency);
+        }
+    }
+
+    const double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(last - start).count());
+    result.achieved_rate = elapsed > 0.0 ? static_cast<double>(total) / elapsed * 1e9 : 0.0;
+    return result;
+}
+
+std::string to_string(const LoadResult& result, Unit unit) {
+    if (result.labels.empty()) return "";
+
+    static const std::pair<double, const char*> qs[] = {
+        {0.50, "p50"}, {0.90, "p90"}, {0.99, "p99"}, {0.999, "p99.9"}, {0.9999, "p99.99"},
+    };
+
+    // The request label, its uncorrected service time, then the inner labels.
+    std::vector<std::pair<std::string, const LatencyHistogram*>> rows;
+    rows.emplace_back(result.labels.front().context, &result.labels.front().latency);
+    rows.emplace_back("(service)", &result.service);
+    for (size_t i = 1; i < result.labels.size(); ++i) rows.emplace_back(result.labels[i].context, &result.labels[i].latency);
+
+    double widest = 0.0;
+    for (const auto& r : rows) widest = std::max(widest, r.second->quantile(0.9999));
+    unit = pick_unit(widest, unit);
+
+    size_t l_ctx{0};
+    std::vector<size_t> col_w;
+    std::vector<std::vector<std::string>> cells(rows.size());
+    for (const auto& q : qs) col_w.push_back(std::strlen(q.second));
+    col_w.push_back(3);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        l_ctx = std::max(l_ctx, text_width(rows[i].first));
+        for (size_t c = 0; c <= std::size(qs); ++c) {
+            const double v = c < std::size(qs) ? rows[i].second->quantile(qs[c].first) : rows[i].second->max();
+            cells[i].push_back(format(v, unit));
+            col_w[c] = std::max(col_w[c], cells[i].back().size());
+        }
+    }
+
+    auto pad = [](const std::string& s, size_t w) { return fence(w - text_width(s), " ") + s; };
+
+    Row head;
+    std::string h = fence(l_ctx + 4, " ");
+    for (size_t c = 0; c < col_w.size(); ++c) h += "  " + pad(c < std::size(qs) ? qs[c].second : "max", col_w[c]);
+    head.add(h + "  " + unit_suffix(unit), ANSI_DIM);
+
+    std::vector<Row> body{head};
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const bool service = i == 1;
+        Row r;
+        r.add(rows[i].first, service ? ANSI_DIM : ANSI_BOLD ANSI_RGB(143,227,125));
+        r.add(fence(l_ctx - text_width(rows[i].first) + 2, "–") + ": ");
+        for (size_t c = 0; c < cells[i].size(); ++c) {
+            r.add("  ");
+            r.add(pad(cells[i][c], col_w[c]), service ? ANSI_DIM : c + 2 >= cells[i].size() && i == 0 ? ANSI_BOLD ANSI_RGB(227,143,125) : "");
+        }
+        body.push_back(r);
+    }
+
+    std::ostringstream rate;
+    rate << "target " << scaled(result.target_rate, false) << "calls/s · achieved "
+         << scaled(result.achieved_rate, false) << "calls/s · " << result.late << " of " << result.calls << " started late";
+    Row f;
+    f.add(rate.str(), result.achieved_rate < 0.99 * result.target_rate ? ANSI_BOLD ANSI_RGB(227,143,125) : ANSI_DIM);
+
+    return table(result.name + "  [open loop, coordinated omission corrected]", {body, {f}});
+}
+
+PeriodicResult periodic(Jamanak& profiler, const std::string& name, const std::function<void()>& work,
+                        const PeriodicOptions& opts) {
+    if (!(opts.period_us > 0.0)) throw std::runtime_error("periodic needs a positive period");
+
+    PeriodicResult result;
+    result.name        = name;
+    result.period_ns   = opts.period_us * 1e3;
+    result.deadline_ns = opts.deadline_us > 0.0 ? opts.deadline_us * 1e3 : result.period_ns;
+    result.cycles      = opts.cycles;
+    result.max_lateness_ns = -result.deadline_ns;
+
+    // Interned once, so the loop records by id without hashing.
+    const auto wake_label = profiler.label_id(name + " wakeup");
+    const auto work_label = profiler.label_id(name);
+    const auto period   = std::chrono::nanoseconds(static_cast<std::int64_t>(result.period_ns));
+    const auto deadline = std::chrono::nanoseconds(static_cast<std::int64_t>(result.deadline_ns));
+
+    profiler.begin_epoch();
+    profiler.reserve(2 * opts.cycles);
+
+    // Everything is measured on the monotonic clock; jam timestamps are mapped to the
+    // profiler's Clock through one fixed anchor, so their durations stay monotonic too.
+    using Mono = std::chrono::steady_clock;
+    const auto anchor_mono = Mono::now();
+    const auto anchor = Clock::now();
+    auto stamp = [&](Mono::time_point t) { return anchor + std::chrono::duration_cast<Clock::duration>(t - anchor_mono); };
+    const auto start = Mono::now() + period;
+    for (size_t k = 0; k < opts.cycles; ++k) {
+        const auto due = start + period * static_cast<std::int64_t>(k);
+#ifdef __linux__
+        // steady_clock is CLOCK_MONOTONIC on Linux, so its time points are valid absolute timeouts.
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(due.time_since_epoch()).count();
+        timespec ts{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#else
+        std::this_thread::sleep_until(due);
+#endif
+        const auto woke = Mono::now();
+        work();
+        const auto done = Mono::now();
+
+        const auto wake_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(woke - due);
+        const auto work_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(done - woke);
+        profiler.record(wake_label, stamp(due), stamp(woke));
+        profiler.record(work_label, stamp(woke), stamp(done));
+        result.wakeup.record(wake_ns.count());
+        result.work.record(work_ns.count());
+
+        const auto late = std::chrono::duration_cast<std::chrono::nanoseconds>(done - (due + deadline)).count();
+        result.max_lateness_ns = std::max(result.max_lateness_ns, static_cast<double>(late));
+        if (late > 0) ++result.misses;
+    }
+
+    profiler.end_epoch();
+    return result;
+}
+
+std::string to_string(const PeriodicResult& result, Unit unit) {
+    if (!result.cycles) return "";
+
+    unit = pick_unit(std::max(result.wakeup.quantile(0.999), result.work.quantile(0.999)), unit);
+    const std::string suffix = std::string(" ") + unit_suffix(unit);
+
+    static const std::pair<double, const char*> qs[] = {{0.50, "p50"}, {0.99, "p99"}, {0.999, "p99.9"}};
+    const std::pair<const char*, const LatencyHistogram*> rows[] = {{"wakeup", &result.wakeup}, {"work", &result.work}};
+
+    std::vector<std::vector<std::string>> cells(2);
+    std::vector<size_t> col_w{3, 3, 3, 5, 3};
+    for (size_t i = 0; i < 2; ++i) {
+        const auto* h = rows[i].second;
+        cells[i].push_back(format(h->mean(), unit));
+        for (const auto& q : qs) cells[i].push_back(format(h->quantile(q.first), unit));
+        cells[i].push_back(format(h->max(), unit));
+        for (size_t c = 0; c < cells[i].size(); ++c) col_w[c] = std::max(col_w[c], cells[i][c].size());
+    }
+
+    auto pad = [](const std::string& s, size_t w) { return fence(w - text_width(s), " ") + s; };
+
+    Row head;
+    head.add(fence(10, " ") + "  " + pad("avg", col_w[0]) + "  " + pad("p50", col_w[1]) + "  " + pad("p99", col_w[2]) +
+             "  " + pad("p99.9", col_w[3]) + "  " + pad("max", col_w[4]) + suffix, ANSI_DIM);
+    std::vector<Row> stats{head};
+    for (size_t i = 0; i < 2; ++i) {
+        Row r;
+        r.add(rows[i].first, ANSI_BOLD ANSI_RGB(143,227,125));
+        r.add(fence(8 - text_width(rows[i].first), "–") + ": ");
+        for (size_t c = 0; c < cells[i].size(); ++c) {
+            r.add("  ");
+            r.add(pad(cells[i][c], col_w[c]), c + 1 == cells[i].size() ? ANSI_BOLD ANSI_RGB(143,227,125) : "");
+        }
+        stats.push_back(r);
+    }
+
+    // Jitter histogram: wakeup latency in 1-2-5 decades, one bar per non-empty range.
+    auto edge = [&](std::int64_t ns) {
+        std::ostringstream ss;
+        ss << static_cast<double>(ns) / unit_ns(unit) << suffix;
+        return ss.str();
+    };
+    std::vector<Row> hist;
+    const std::int64_t edges[] = {1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000,
+                                  2000000, 5000000, 10000000, std::numeric_limits<std::int64_t>::max()};
+    std::uint64_t most = 0;
+    std::vector<std::pair<std::string, std::uint64_t>> bins;
+    std::int64_t lo = -1;
+    for (auto hi : edges) {
+        const std::uint64_t n = result.wakeup.count_above(lo) - result.wakeup.count_above(hi);
+        lo = hi;
+        if (!n && bins.empty()) continue;
+        const std::string label = hi == edges[std::size(edges) - 1] ? "> " + edge(edges[std::size(edges) - 2]) : "≤ " + edge(hi);
+        bins.emplace_back(label, n);
+        most = std::max(most, n);
+        if (result.wakeup.count_above(hi) == 0) break;
+    }
+    const size_t bar_w = 32;
+    size_t l_n = 1;
+    size_t l_lab = 0;
+    for (const auto& b : bins) {
+        l_n = std::max(l_n, std::to_string(b.second).size());
+        l_lab = std::max(l_lab, text_width(b.first));
+    }
+    for (const auto& b : bins) {
+        const size_t len = most ? static_cast<size_t>(static_cast<double>(b.second) / static_cast<double>(most) * bar_w + 0.5) : 0;
+        Row r;
+        r.add(pad(b.first, l_lab) + "  ", ANSI_DIM);
+        r.add(fence(std::max<size_t>(len, b.second ? 1 : 0), "█"), ANSI_RGB(143,227,125));
+        r.add(fence(bar_w - std::max<size_t>(len, b.second ? 1 : 0), " ") + "  " + pad(std::to_string(b.second), l_n));
+        hist.push_back(r);
+    }
+
+    std::ostringstream miss, late;
+    miss << result.misses << " of " << result.cycles << " deadlines missed";
+    late << "max lateness " << format(result.max_lateness_ns, unit) << suffix << " (deadline "
+         << format(result.deadline_ns, unit) << suffix << ")";
+    Row m, l;
+    m.add(miss.str(), result.misses ? ANSI_BOLD ANSI_RGB(227,143,125) : ANSI_BOLD ANSI_RGB(143,227,125));
+    l.add(late.str(), result.max_lateness_ns > 0.0 ? ANSI_BOLD ANSI_RGB(227,143,125) : ANSI_DIM);
+
+    return table(result.name + "  [periodic " + format(result.period_ns, unit) + suffix + ", " +
+                 std::to_string(result.cycles) + " cycles]", {stats, hist, {m, l}});
+}
+
+FrameBudget::FrameBudget(Jamanak& profiler, double budget_ms, size_t keep_frames)
+    : profiler(profiler), budget_ns(budget_ms * 1e6), keep(keep_frames) {
+    if (!(budget_ms > 0.0)) throw std::runtime_error("frame budget must be positive");
+    if (!keep_frames) throw std::runtime_error("frame budget must keep at least one frame");
+}
+
+void FrameBudget::begin_frame() {
+    profiler.begin_epoch();
+    frame_t0 = std::chrono::steady_clock::now();
+}
+
+double FrameBudget::end_frame() {
+    const auto t1 = std::chrono::steady_clock::now();
+    last_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - frame_t0).count());
+    times.record(static_cast<std::int64_t>(last_ns));
+
+    // Only over-budget frames pay for the per-label breakdown, read from the packed jams.
+    if (last_ns > budget_ns) {
+        const size_t n_labels = profiler.labels.size();
+        if (slot.size() < n_labels) {
+            slot.resize(n_labels, 0);
+            over_ns.resize(n_labels, 0.0);
+            over_frames.resize(n_labels, 0);
+        }
+
+        scratch.frame = frames;
+        scratch.frame_ns = last_ns;
+        scratch.stages.clear();
+        for (const auto& j : profiler.current()) {
+            if (!slot[j.label]) {
+                scratch.stages.emplace_back(j.label, 0.0);
+                slot[j.label] = scratch.stages.size();
+            }
+            scratch.stages[slot[j.label] - 1].second += static_cast<double>(j.dur_ns);
+        }
+        for (const auto& st : scratch.stages) {
+            slot[st.first] = 0;
+            over_ns[st.first] += st.second;
+            ++over_frames[st.first];
+        }
+        std::stable_sort(scratch.stages.begin(), scratch.stages.end(),
+                         [](const auto& a, const auto& b) { return a.second > b.second; });
+
+        const size_t keep = 5;
+        if (worst.size() < keep || last_ns > worst.back().frame_ns) {
+            auto pos = std::find_if(worst.begin(), worst.end(), [&](const OverBudgetFrame& w) { return last_ns > w.frame_ns; });
+            pos = worst.insert(pos, OverBudgetFrame{});
+            std::swap(*pos, scratch);
+            if (worst.size() > keep) {
+                std::swap(scratch, worst.back());
+                worst.pop_back();
+            }
+        }
+        ++over;
+    }
+
+    // Dropping in batches of keep frames spreads the cost of erasing the oldest epochs.
+    profiler.end_epoch();
+    if (profiler.epoch_count() >= 2 * keep) profiler.drop_epochs(profiler.epoch_count() - keep);
+    ++frames;
+    return last_ns;
+}
+
+const char* FrameBudget::hud() {
+    // Each quantile scans every bucket, so they are refreshed every hud_every frames.
+    if (frames != hud_frames && (frames < hud_every || frames - hud_frames >= hud_every)) {
+        hud_p50 = times.quantile(0.50);
+        hud_p99 = times.quantile(0.99);
+        hud_frames = frames;
+    }
+    const double mean = times.mean();
+    std::snprintf(line.data(), line.size(),
+                  "frame %6.2f ms | p50 %6.2f | p99 %6.2f | over %zu/%zu (%.1f%%) | %5.1f fps | budget %.1f ms",
+                  last_ns / 1e6, hud_p50 / 1e6, hud_p99 / 1e6, over, frames,
+                  frames ? 100.0 * static_cast<double>(over) / static_cast<double>(frames) : 0.0,
+                  mean > 0.0 ? 1e9 / mean : 0.0, budget_ns / 1e6);
+    return line.data();
+}
+
+std::vector<FrameStage> FrameBudget::over_budget_stages() const {
+    std::vector<FrameStage> out;
+    for (size_t id = 0; id < over_frames.size(); ++id) {
+        if (over_frames[id]) out.push_back({profiler.labels[id], over_ns[id], over_frames[id]});
+    }
+    std::stable_sort(out.begin(), out.end(), [](const FrameStage& a, const FrameStage& b) { return a.over_ns > b.over_ns; });
+    return out;
+}
+
+std::string FrameBudget::to_string() const {
+    if (!frames) return "";
+
+    const Unit unit = Unit::milli;
+    const std::string suffix = std::string(" ") + unit_suffix(unit);
+    auto pad = [](const std::string& s, size_t w) { return fence(w - text_width(s), " ") + s; };
+
+    static const std::pair<double, const char*> qs[] = {{0.50, "p50"}, {0.90, "p90"}, {0.99, "p99"}, {0.999, "p99.9"}};
+    std::vector<std::string> cells;
+    std::vector<std::string> hdrs;
+    for (const auto& q : qs) {
+        cells.push_back(format(times.quantile(q.first), unit));
+        hdrs.push_back(q.second);
+    }
+    cells.push_back(format(times.max(), unit));
+    hdrs.push_back("max");
+
+    Row head, vals;
+    std::string h, v;
+    for (size_t c = 0; c < cells.size(); ++c) {
+        const size_t w = std::max(cells[c].size(), hdrs[c].size());
+        h += (c ? "  " : "") + pad(hdrs[c], w);
+        v += (c ? "  " : "") + pad(cells[c], w);
+    }
+    head.add("frame time  " + h + suffix, ANSI_DIM);
+    vals.add(fence(12, " "));
+    vals.add(v, ANSI_BOLD ANSI_RGB(143,227,125));
+
+    std::ostringstream ov;
+    ov << over << " of " << frames << " frames over budget (" << std::fixed << std::setprecision(1)
+       << 100.0 * static_cast<double>(over) / static_cast<double>(frames) << "%)";
+    Row o;
+    o.add(ov.str(), over ? ANSI_BOLD ANSI_RGB(227,143,125) : ANSI_BOLD ANSI_RGB(143,227,125));
+
+    std::vector<std::vector<Row>> sections{{head, vals}, {o}};
+
+    // Share of every stage in the over-budget frames, then the slowest frames themselves.
+    const auto ranked = over_budget_stages();
+    if (!ranked.empty()) {
+        double over_total = 0.0;
+        for (const auto& st : ranked) over_total += st.over_ns;
+
+        size_t l_ctx = 0;
+        for (const auto& st : ranked) l_ctx = std::max(l_ctx, text_width(st.context));
+
+        std::vector<Row> shares;
+        Row sh;
+        sh.add("in over-budget frames", ANSI_DIM);
+        shares.push_back(sh);
+        for (const auto& st : ranked) {
+            std::ostringstream pct;
+            pct << std::fixed << std::setprecision(1) << (over_total > 0.0 ? st.over_ns / over_total * 100.0 : 0.0) << "%";
+            Row r;
+            r.add(st.context, ANSI_BOLD ANSI_RGB(143,227,125));
+            r.add(fence(l_ctx - text_width(st.context) + 2, "–") + ": ");
+            r.add(pad(pct.str(), 6), ANSI_BOLD ANSI_RGB(227,143,125));
+            r.add("  " + format(st.over_ns / static_cast<double>(st.frames), unit) + suffix + " per frame", ANSI_DIM);
+            shares.push_back(r);
+        }
+        sections.push_back(shares);
+
+        std::vector<Row> frames_rows;
+        for (const auto& f : worst) {
+            std::ostringstream ss;
+            ss << "frame " << f.frame << ": " << format(f.frame_ns, unit) << suffix;
+            Row r;
+            r.add(ss.str(), ANSI_BOLD ANSI_RGB(227,143,125));
+            for (size_t i = 0; i < f.stages.size() && i < 3; ++i) {
+                std::ostringstream st;
+                st << (i ? ", " : " ─ ") << profiler.labels[f.stages[i].first] << " " << std::fixed << std::setprecision(0)
+                   << f.stages[i].second / f.frame_ns * 100.0 << "%";
+                r.add(st.str(), ANSI_DIM);
+            }
+            frames_rows.push_back(r);
+        }
+        sections.push_back(frames_rows);
+    }
+
+    std::ostringstream hdr;
+    hdr << "frames  [budget " << std::fixed << std::setprecision(1) << budget_ns / 1e6 << " ms]";
+    return table(hdr.str(), sections);
+}
+
+} // namespace jamanak
@@ -0,0 +1,161 @@
+/// @file jamanak_session.cpp
+/// @brief Thread pinning, priority and sysfs/procfs probing of benchmark sessions.
+
+#include "jamanak_session.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace jamanak {
+
+namespace {
+
+/// @brief Returns the first line of @p path without the newline; empty if unreadable.
+std::string read_line(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    if (in) std::getline(in, line);
+    return line;
+}
+
+/// @brief Returns the "model name" of /proc/cpuinfo; empty if unavailable.
+std::string cpu_model() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 10, "model name") != 0) continue;
+        auto colon = line.find(':');
+        if (colon == std::string::npos) break;
+        auto first = line.find_first_not_of(" \t", colon + 1);
+        return first == std::string::npos ? "" : line.substr(first);
+    }
+    return "";
+}
+
+/// @brief Returns the turbo state from intel_pstate or the generic cpufreq boost switch.
+int turbo_state() {
+    auto no_turbo = read_line("/sys/devices/system/cpu/intel_pstate/no_turbo");
+    if (!no_turbo.empty()) return no_turbo == "0" ? 1 : 0;
+    auto boost = read_line("/sys/devices/system/cpu/cpufreq/boost");
+    if (!boost.empty()) return boost == "1" ? 1 : 0;
+    return -1;
+}
+
+#ifdef __linux__
+/// @brief Returns the kernel thread id of the caller (setpriority acts per thread on Linux).
+id_t thread_id() { return static_cast<id_t>(syscall(SYS_gettid)); }
+#endif
+
+} // namespace
+
+Environment probe_environment(int cpu, double max_load) {
+    Environment env;
+    env.probed    = true;
+    env.cpus      = std::thread::hardware_concurrency();
+    env.cpu_model = cpu_model();
+
+#ifdef __linux__
+    char host[256] = {};
+    if (gethostname(host, sizeof(host) - 1) == 0) env.host = host;
+
+    if (cpu < 0) cpu = sched_getcpu();
+    errno = 0;
+    const int nice = getpriority(PRIO_PROCESS, thread_id());
+    if (errno == 0) env.nice = nice;
+
+    if (cpu >= 0) {
+        const std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        env.governor = read_line(dir + "/cpufreq/scaling_governor");
+        auto siblings = read_line(dir + "/topology/thread_siblings_list");
+        if (siblings.find_first_of(",-") != std::string::npos) env.siblings = siblings;
+    }
+
+    std::ifstream loadavg("/proc/loadavg");
+    loadavg >> env.load[0] >> env.load[1] >> env.load[2];
+#else
+    (void)cpu;
+#endif
+    env.turbo = turbo_state();
+
+    if (!env.governor.empty() && env.governor != "performance")
+        env.warnings.push_back("cpufreq governor is '" + env.governor + "', not 'performance'");
+    if (env.turbo == 1)
+        env.warnings.push_back("turbo boost is on; clock speed depends on temperature and load");
+    if (!env.siblings.empty())
+        env.warnings.push_back("smt siblings " + env.siblings + " share the measuring core");
+    if (env.load[0] > max_load) {
+        std::ostringstream w;
+        w << "load average is " << env.load[0] << " (> " << max_load << ")";
+        env.warnings.push_back(w.str());
+    }
+
+    return env;
+}
+
+Session::Session(const SessionOptions& opts) {
+    int cpu = opts.cpu;
+    std::vector<std::string> failures;
+
+#ifdef __linux__
+    if (cpu < 0) cpu = sched_getcpu();
+
+    if (opts.pin && cpu < 0) {
+        failures.push_back("cannot determine the current cpu; not pinned");
+    } else if (opts.pin) {
+        cpu_set_t old_set, set;
+        if (sched_getaffinity(0, sizeof(old_set), &old_set) == 0) {
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            if (sched_setaffinity(0, sizeof(set), &set) == 0) {
+                const auto* bytes = reinterpret_cast<const unsigned char*>(&old_set);
+                old_affinity.assign(bytes, bytes + sizeof(old_set));
+                restore_affinity = true;
+            } else {
+                failures.push_back("cannot pin to cpu " + std::to_string(cpu));
+            }
+        } else {
+            failures.push_back("cannot read the cpu affinity; not pinned");
+        }
+    }
+
+    if (opts.raise_priority) {
+        errno = 0;
+        old_nice = getpriority(PRIO_PROCESS, thread_id());
+        if (errno == 0 && setpriority(PRIO_PROCESS, thread_id(), -20) == 0) restore_nice = true;
+        else failures.push_back("cannot raise priority (needs CAP_SYS_NICE)");
+    }
+#else
+    if (opts.pin || opts.raise_priority) failures.push_back("pinning and priority are only supported on Linux");
+#endif
+
+    env = probe_environment(cpu, opts.max_load);
+    if (restore_affinity) env.cpu = cpu;
+    env.warnings.insert(env.warnings.begin(), failures.begin(), failures.end());
+
+    if (opts.warn) {
+        for (const auto& w : env.warnings) std::fprintf(stderr, "jamanak: warning: %s\n", w.c_str());
+    }
+}
+
+Session::~Session() {
+#ifdef __linux__
+    if (restore_affinity) {
+        cpu_set_t set;
+        std::copy(old_affinity.begin(), old_affinity.end(), reinterpret_cast<unsigned char*>(&set));
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+    if (restore_nice) setpriority(PRIO_PROCESS, thread_id(), old_nice);
+#endif
+}
+
+} // namespace jamanak
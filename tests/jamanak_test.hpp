@@ -0,0 +1,69 @@
+/// @file jamanak_test.hpp
+/// @brief Minimal checks and synthetic epochs shared by the unit tests.
+///
+/// Every test feeds the profiler jams with fixed timestamps through
+/// Jamanak::record() and Jamanak::import_epoch(), so the expected statistics
+/// can be computed by hand and the results do not depend on the machine.
+
+#pragma once
+
+#include "jamanak.hpp"
+#include "jamanak_analysis.hpp"
+#include "jamanak_stages.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace jamanak_test {
+
+inline int failures = 0;                                   ///< Failed checks so far.
+
+/// @brief Reports a failed check.
+inline void fail(const char* file, int line, const std::string& what) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what.c_str());
+    ++failures;
+}
+
+/// @brief Prints the summary of @p suite; returns the process exit code.
+inline int finish(const char* suite) {
+    if (failures) std::fprintf(stderr, "%s: %d check(s) failed\n", suite, failures);
+    else          std::printf("%s: all checks passed\n", suite);
+    return failures ? 1 : 0;
+}
+
+/// @brief Returns the time point @p ns nanoseconds after @p base.
+inline jamanak::Clock::time_point at(jamanak::Clock::time_point base, std::int64_t ns) {
+    return base + std::chrono::nanoseconds(ns);
+}
+
+/// @brief Returns a jam labelled @p context from @p t0 to @p t1 (ns after @p base) on lane @p thread.
+inline jamanak::Jam jam(jamanak::Clock::time_point base, const std::string& context,
+                        std::int64_t t0, std::int64_t t1, size_t thread = 0) {
+    jamanak::Jam j;
+    j.context = context;
+    j.t0 = at(base, t0);
+    j.t1 = at(base, t1);
+    j.duration_ns = t1 - t0;
+    j.duration_ms = static_cast<double>(t1 - t0) / 1e6;
+    j.thread = thread;
+    return j;
+}
+
+/// @brief Deterministic noise in [-5, 5] for index @p i.
+inline double wiggle(size_t i) { return static_cast<double>((i * 37) % 11) - 5.0; }
+
+} // namespace jamanak_test
+
+#define CHECK(cond) \
+    do { if (!(cond)) jamanak_test::fail(__FILE__, __LINE__, #cond); } while (0)
+
+#define CHECK_NEAR(a, b, tol) \
+    do { \
+        const double check_a_ = static_cast<double>(a), check_b_ = static_cast<double>(b); \
+        if (!(std::fabs(check_a_ - check_b_) <= (tol))) \
+            jamanak_test::fail(__FILE__, __LINE__, std::string(#a " == " #b " (") + std::to_string(check_a_) + \
+                               " vs " + std::to_string(check_b_) + ")"); \
+    } while (0)
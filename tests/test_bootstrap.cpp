@@ -0,0 +1,95 @@
+/// @file test_bootstrap.cpp
+/// @brief Bootstrap confidence intervals of label means, medians and times per epoch.
+
+#include "jamanak_test.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace jamanak;
+using jamanak_test::jam;
+
+namespace {
+
+/// Returns the stats of @p context, or an empty entry if it is missing.
+LabelStats find(const std::vector<LabelStats>& stats, const std::string& context) {
+    for (const auto& s : stats) if (s.context == context) return s;
+    CHECK(!"label missing");
+    return {};
+}
+
+/// Intervals contain the point estimate, collapse on constant data and do not depend on the thread count.
+void test_bootstrap() {
+    Jamanak p("bootstrap");
+    const auto base = Clock::now();
+
+    for (size_t i = 0; i < 40; ++i) {
+        const std::int64_t t = static_cast<std::int64_t>(i) * 100000;
+        const std::int64_t a = 1000 + static_cast<std::int64_t>(jamanak_test::wiggle(i) * 20.0);
+        p.import_epoch({jam(base, "a", t, t + a), jam(base, "c", t + a, t + a + 700)},
+                       jamanak_test::at(base, t), jamanak_test::at(base, t + a + 700));
+    }
+
+    const auto one  = p.label_stats(BootstrapOptions{700, 0.95, 42, 1});
+    const auto four = p.label_stats(BootstrapOptions{700, 0.95, 42, 4});
+    const auto plain = p.label_stats();
+    CHECK(one.size() == 2 && four.size() == 2);
+
+    for (size_t l = 0; l < one.size(); ++l) {
+        CHECK(one[l].epoch_lo_ns == four[l].epoch_lo_ns);
+        CHECK(one[l].epoch_hi_ns == four[l].epoch_hi_ns);
+        CHECK(one[l].mean_lo_ns == four[l].mean_lo_ns);
+        CHECK(one[l].mean_hi_ns == four[l].mean_hi_ns);
+        CHECK(one[l].p50_lo_ns == four[l].p50_lo_ns);
+        CHECK(one[l].p50_hi_ns == four[l].p50_hi_ns);
+        CHECK(one[l].mean_ns == plain[l].mean_ns);
+    }
+
+    const auto a = find(one, "a");
+    CHECK(a.epoch_lo_ns <= a.epoch_ns && a.epoch_ns <= a.epoch_hi_ns);
+    CHECK(a.mean_lo_ns <= a.mean_ns && a.mean_ns <= a.mean_hi_ns);
+    CHECK(a.p50_lo_ns <= a.p50_ns && a.p50_ns <= a.p50_hi_ns);
+    CHECK(a.mean_lo_ns < a.mean_hi_ns);
+    // The interval of the mean is about ±2 standard errors wide.
+    const double se = a.stddev_ns / std::sqrt(40.0);
+    CHECK(a.mean_hi_ns - a.mean_lo_ns > 2.0 * se && a.mean_hi_ns - a.mean_lo_ns < 6.0 * se);
+
+    const auto c = find(one, "c");
+    CHECK(c.epoch_lo_ns == 700.0 && c.epoch_hi_ns == 700.0);
+    CHECK(c.mean_lo_ns == 700.0 && c.mean_hi_ns == 700.0);
+    CHECK(c.p50_lo_ns == 700.0 && c.p50_hi_ns == 700.0);
+}
+
+/// The same seed gives the same intervals, and the report shows them only when asked.
+void test_seed_and_report() {
+    Jamanak p("bootstrap");
+    const auto base = Clock::now();
+    for (size_t i = 0; i < 20; ++i) {
+        const std::int64_t t = static_cast<std::int64_t>(i) * 100000;
+        const std::int64_t a = 2000 + static_cast<std::int64_t>(jamanak_test::wiggle(i) * 50.0);
+        p.import_epoch({jam(base, "a", t, t + a)}, jamanak_test::at(base, t), jamanak_test::at(base, t + a));
+    }
+
+    const auto x = find(p.label_stats(BootstrapOptions{500, 0.9, 7, 2}), "a");
+    const auto y = find(p.label_stats(BootstrapOptions{500, 0.9, 7, 3}), "a");
+    CHECK(x.mean_lo_ns == y.mean_lo_ns && x.mean_hi_ns == y.mean_hi_ns);
+    CHECK(x.epoch_lo_ns == y.epoch_lo_ns && x.epoch_hi_ns == y.epoch_hi_ns);
+
+    // A wider confidence level never gives a narrower interval.
+    const auto wide = find(p.label_stats(BootstrapOptions{500, 0.99, 7, 2}), "a");
+    CHECK(wide.mean_hi_ns - wide.mean_lo_ns >= x.mean_hi_ns - x.mean_lo_ns);
+
+    ReportOptions opts;
+    opts.bootstrap = 200;
+    CHECK(p.to_string_epochs(opts).find("±") != std::string::npos);
+    CHECK(p.to_string_epochs().find("±") == std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    test_bootstrap();
+    test_seed_and_report();
+    return jamanak_test::finish("bootstrap");
+}
@@ -0,0 +1,159 @@
+/// @file test_critical_path.cpp
+/// @brief Fork/join edges, the per-epoch schedule and the critical path.
+
+#include "jamanak_test.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jamanak;
+using jamanak_test::at;
+
+namespace {
+
+/// Fixed jams with explicit edges: the path follows the longest chain.
+void test_explicit_edges() {
+    Jamanak p("critical");
+    const auto base = Clock::now();
+
+    const size_t split = p.record("split", base, at(base, 1000));
+    const size_t work  = p.record("work", at(base, 1000), at(base, 4000), 1);
+    const size_t side  = p.record("side", at(base, 1000), at(base, 2000));
+    const size_t merge = p.record("merge", at(base, 4000), at(base, 4500));
+    p.link(split, work, EdgeKind::spawn);
+    p.link(work, merge, EdgeKind::join);
+    p.end_epoch();
+
+    CHECK(p.critical_path(0) == std::vector<size_t>({split, work, merge}));
+    CHECK_NEAR(p.critical_path_ns(), 4500.0, 1e-9);
+
+    for (const auto& c : p.critical_labels()) {
+        if (c.context == "side") {
+            CHECK(c.on_path == 0);
+            CHECK_NEAR(c.mean_slack_ns, 2000.0, 1e-9);
+        } else {
+            CHECK(c.on_path == 1);
+            CHECK_NEAR(c.mean_slack_ns, 0.0, 1e-9);
+        }
+    }
+}
+
+/// A jam already running when a lane is joined does not wait for it; the next one does.
+void test_join_edges() {
+    Jamanak p("critical");
+
+    p.start("wait");
+    auto lane = p.fork();
+    std::thread worker([&lane] {
+        lane.start("work");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        lane.stop();
+    });
+    worker.join();
+    p.join(lane);
+    const size_t wait = p.stop();
+
+    const auto t0 = Clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const size_t after = p.record("after", t0, Clock::now());
+    p.end_epoch();
+
+    // Chaining "wait" after "work" would make the path longer than the epoch itself.
+    CHECK(p.critical_path_ns() <= p.epoch_wall_ns());
+    const auto path = p.critical_path(0);
+    CHECK(!path.empty() && path.back() == after);
+    CHECK(path.size() == 2);
+    CHECK(wait != after);
+}
+
+/// Nested jams on one lane are contained in their parent instead of chained after it.
+void test_nested() {
+    Jamanak p("critical");
+    const auto base = Clock::now();
+
+    const size_t main  = p.record("main", base, at(base, 500));
+    const size_t outer = p.record("outer", base, at(base, 1000000), 1);
+    const size_t inner = p.record("inner", at(base, 100000), at(base, 900000), 1);
+    const size_t deep  = p.record("deep", at(base, 200000), at(base, 300000), 1);
+    const size_t next  = p.record("next", at(base, 1000000), at(base, 1200000), 1);
+    p.end_epoch();
+
+    CHECK_NEAR(p.critical_path_ns(), 1200000.0, 1e-9);
+    CHECK(p.critical_path(0) == std::vector<size_t>({outer, next}));
+    CHECK(main != inner && inner != deep);
+
+    // Over several epochs, the time split for jitter attribution still adds up.
+    Jamanak q("critical");
+    const auto later = Clock::now();
+    for (std::int64_t e = 0; e < 10; ++e) {
+        const std::int64_t t = e * 10000000, v = 100000 + 10000 * (e % 3);
+        q.import_epoch({jamanak_test::jam(later, "outer", t, t + 1000000 + v, 1),
+                        jamanak_test::jam(later, "inner", t + 100000, t + 200000 + v, 1),
+                        jamanak_test::jam(later, "next", t + 1000000 + v, t + 1200000 + v, 1)},
+                       at(later, t), at(later, t + 1250000 + v));
+    }
+    CHECK(q.saturated_jams() == 0);
+    CHECK_NEAR(q.critical_path_ns(), 1309000.0, 1e-9);
+    CHECK(q.critical_path_ns() <= q.epoch_wall_ns());
+    double share = 0.0;
+    for (const auto& c : q.jitter_contributors()) {
+        share += c.share;
+        if (c.context == "untracked") CHECK_NEAR(c.stddev_ns, 0.0, 1e-9);
+        if (c.context == "inner") CHECK_NEAR(c.share, 1.0, 1e-9);
+    }
+    CHECK_NEAR(share, 1.0, 1e-9);
+}
+
+/// Lanes cannot be joined into a later epoch, where their parent id means another jam.
+void test_stale_lane() {
+    Jamanak p("critical");
+    const auto base = Clock::now();
+    p.record("a", base, at(base, 1000));
+
+    auto lane = p.fork();
+    lane.start("work");
+    lane.stop();
+    p.end_epoch();
+
+    bool threw = false;
+    try {
+        p.join(lane);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(p.jam_count() == 0);
+
+    auto fresh = p.fork();
+    fresh.start("work");
+    fresh.stop();
+    p.begin_epoch();
+    threw = false;
+    try {
+        p.join(fresh);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // A lane of the current epoch still joins.
+    p.record("b", base, at(base, 1000));
+    auto ok = p.fork();
+    ok.start("work");
+    ok.stop();
+    p.join(ok);
+    CHECK(p.jam_count() == 2);
+}
+
+} // namespace
+
+int main() {
+    test_explicit_edges();
+    test_join_edges();
+    test_nested();
+    test_stale_lane();
+    return jamanak_test::finish("critical_path");
+}
@@ -0,0 +1,86 @@
+/// @file test_frame_budget.cpp
+/// @brief Frame budgets: recent frames kept as epochs, overrun accounting and the HUD line.
+
+#include "jamanak_test.hpp"
+#include "jamanak_runner.hpp"
+
+#include <stdexcept>
+#include <string>
+
+using namespace jamanak;
+using jamanak_test::at;
+
+namespace {
+
+/// Completed frames stay as epochs, with the oldest dropped in batches of keep_frames.
+void test_retention() {
+    Jamanak p("frames");
+    FrameBudget frames(p, 1000.0, 4);
+
+    for (size_t i = 0; i < 50; ++i) {
+        frames.begin_frame();
+        const auto base = Clock::now();
+        p.record("update", base, at(base, 1000));
+        p.record("render", at(base, 1000), at(base, 3000));
+        frames.end_frame();
+
+        CHECK(p.epoch_count() >= 1 && p.epoch_count() < 8);
+        CHECK(p.epoch_count() + p.dropped_epochs() == i + 1);
+    }
+    CHECK(p.epoch_count() >= 4);
+    CHECK(frames.frame_times().count() == 50);
+    CHECK(frames.overruns() == 0);
+    CHECK(frames.over_budget_stages().empty());
+
+    const auto stats = p.label_stats();
+    CHECK(stats.size() == 2);
+    for (const auto& s : stats) {
+        CHECK(s.count == p.epoch_count());
+        CHECK_NEAR(s.mean_ns, s.context == "render" ? 2000.0 : 1000.0, 1e-9);
+    }
+
+    bool threw = false;
+    try {
+        FrameBudget none(p, 16.6, 0);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+/// Every frame over a tiny budget is broken down by label; the HUD line reports it.
+void test_overruns() {
+    Jamanak p("frames");
+    FrameBudget frames(p, 1e-6);
+
+    const std::string empty = frames.hud();
+    CHECK(empty.find("over 0/0") != std::string::npos);
+
+    for (size_t i = 0; i < 40; ++i) {
+        frames.begin_frame();
+        const auto base = Clock::now();
+        p.record("update", base, at(base, 1000));
+        p.record("render", at(base, 1000), at(base, 4000));
+        CHECK(frames.end_frame() > 0.0);
+    }
+    CHECK(frames.overruns() == 40);
+    CHECK(p.epoch_count() == 40);
+
+    const auto ranked = frames.over_budget_stages();
+    CHECK(ranked.size() == 2);
+    CHECK(ranked[0].context == "render" && ranked[0].frames == 40);
+    CHECK_NEAR(ranked[0].over_ns, 40 * 3000.0, 1e-6);
+    CHECK_NEAR(ranked[1].over_ns, 40 * 1000.0, 1e-6);
+
+    const std::string line = frames.hud();
+    CHECK(line.find("over 40/40 (100.0%)") != std::string::npos);
+    CHECK(frames.to_string().find("render") != std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    test_retention();
+    test_overruns();
+    return jamanak_test::finish("frame_budget");
+}
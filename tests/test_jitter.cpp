@@ -0,0 +1,158 @@
+/// @file test_jitter.cpp
+/// @brief Wall-time variance decomposition: exclusive attribution, co-moments and the untracked column.
+
+#include "jamanak_test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace jamanak;
+using jamanak_test::jam;
+using jamanak_test::wiggle;
+
+namespace {
+
+/// Returns the contributor named @p context, or an empty entry if it is missing.
+JitterContributor find(const std::vector<JitterContributor>& js, const std::string& context) {
+    for (const auto& j : js) if (j.context == context) return j;
+    CHECK(!"contributor missing");
+    return {};
+}
+
+/// Returns the sum of all shares.
+double total_share(const std::vector<JitterContributor>& js) {
+    double s = 0.0;
+    for (const auto& j : js) s += j.share;
+    return s;
+}
+
+/// Returns the sample variance of @p x, two-pass.
+double variance(const std::vector<double>& x) {
+    double m = 0.0, v = 0.0;
+    for (double y : x) m += y;
+    m /= static_cast<double>(x.size());
+    for (double y : x) v += (y - m) * (y - m);
+    return v / static_cast<double>(x.size() - 1);
+}
+
+/// Back-to-back jams: the one varying label takes the whole variance.
+void test_sequential() {
+    Jamanak p("jitter");
+    const auto base = Clock::now();
+    std::vector<double> a_ns;
+
+    // "a" varies, "b" is constant, and 100 ns between "b" and the epoch end stay untracked.
+    for (size_t i = 0; i < 40; ++i) {
+        const std::int64_t t = static_cast<std::int64_t>(i) * 100000;
+        const auto a = static_cast<std::int64_t>(1000.0 + 50.0 * wiggle(i));
+        a_ns.push_back(static_cast<double>(a));
+        p.import_epoch({jam(base, "a", t, t + a), jam(base, "b", t + a, t + a + 500)},
+                       jamanak_test::at(base, t), jamanak_test::at(base, t + a + 600));
+    }
+
+    const auto js = p.jitter_contributors();
+    CHECK(js.size() == 3);
+    CHECK(js.front().context == "a");
+    CHECK_NEAR(total_share(js), 1.0, 1e-9);
+
+    const auto a = find(js, "a");
+    CHECK_NEAR(a.share, 1.0, 1e-9);
+    CHECK_NEAR(a.correlation, 1.0, 1e-9);
+    CHECK_NEAR(a.covariance, variance(a_ns), 1e-6);
+    CHECK_NEAR(a.stddev_ns, std::sqrt(variance(a_ns)), 1e-9);
+
+    const auto b = find(js, "b"), u = find(js, "untracked");
+    CHECK_NEAR(b.share, 0.0, 1e-9);
+    CHECK_NEAR(b.stddev_ns, 0.0, 1e-9);
+    CHECK_NEAR(u.share, 0.0, 1e-9);
+    CHECK_NEAR(u.stddev_ns, 0.0, 1e-9);
+    CHECK_NEAR(p.epoch_untracked_ns(), 100.0, 1e-9);
+
+    ReportOptions opts;
+    opts.jitter = true;
+    CHECK(p.to_string_epochs(opts).find("jitter contributors") != std::string::npos);
+    CHECK(p.to_string_epochs().find("jitter contributors") == std::string::npos);
+}
+
+/// Nested jams: time is attributed to the innermost one only.
+void test_nested() {
+    Jamanak p("jitter");
+    const auto base = Clock::now();
+
+    // "outer" spans 1000 ns plus the varying "inner" it contains.
+    for (size_t i = 0; i < 40; ++i) {
+        const std::int64_t t = static_cast<std::int64_t>(i) * 100000;
+        const auto v = static_cast<std::int64_t>(800.0 + 70.0 * wiggle(i));
+        p.import_epoch({jam(base, "outer", t, t + 1000 + v), jam(base, "inner", t + 100, t + 100 + v)},
+                       jamanak_test::at(base, t), jamanak_test::at(base, t + 1000 + v));
+    }
+
+    const auto js = p.jitter_contributors();
+    CHECK_NEAR(total_share(js), 1.0, 1e-9);
+    CHECK_NEAR(find(js, "inner").share, 1.0, 1e-9);
+    CHECK_NEAR(find(js, "outer").share, 0.0, 1e-9);
+    CHECK_NEAR(find(js, "outer").stddev_ns, 0.0, 1e-9);
+    CHECK_NEAR(find(js, "untracked").stddev_ns, 0.0, 1e-9);
+    CHECK_NEAR(p.epoch_untracked_ns(), 0.0, 1e-9);
+}
+
+/// Parallel lanes: overlapping jams are counted once, so untracked is the real gap.
+void test_lanes() {
+    Jamanak p("jitter");
+    const auto base = Clock::now();
+
+    // Main thread runs 1000 ns; the lane runs 500..1500 ns alongside; 50 ns of tail stay untracked.
+    for (size_t i = 0; i < 40; ++i) {
+        const std::int64_t t = static_cast<std::int64_t>(i) * 100000;
+        const auto w = static_cast<std::int64_t>(1000.0 + 100.0 * wiggle(i));
+        const std::int64_t end = std::max<std::int64_t>(1000, w) + 50;
+        p.import_epoch({jam(base, "main", t, t + 1000), jam(base, "worker", t, t + w, 1)},
+                       jamanak_test::at(base, t), jamanak_test::at(base, t + end));
+    }
+
+    const auto js = p.jitter_contributors();
+    CHECK(js.size() == 3);
+    CHECK_NEAR(total_share(js), 1.0, 1e-9);
+    const auto u = find(js, "untracked");
+    CHECK_NEAR(u.stddev_ns, 0.0, 1e-9);
+    CHECK_NEAR(u.share, 0.0, 1e-9);
+    CHECK_NEAR(p.epoch_untracked_ns(), 50.0, 1e-9);
+    CHECK(find(js, "worker").share > 0.5);
+}
+
+/// Gaps that vary between constant jams show up as untracked jitter.
+void test_untracked() {
+    Jamanak p("jitter");
+    const auto base = Clock::now();
+
+    for (size_t i = 0; i < 40; ++i) {
+        const std::int64_t t = static_cast<std::int64_t>(i) * 100000;
+        const auto gap = static_cast<std::int64_t>(300.0 + 40.0 * wiggle(i));
+        p.import_epoch({jam(base, "a", t, t + 1000), jam(base, "b", t + 1000 + gap, t + 1500 + gap)},
+                       jamanak_test::at(base, t), jamanak_test::at(base, t + 1500 + gap));
+    }
+
+    const auto js = p.jitter_contributors();
+    CHECK(js.front().context == "untracked");
+    CHECK_NEAR(js.front().share, 1.0, 1e-9);
+    CHECK_NEAR(total_share(js), 1.0, 1e-9);
+
+    // Fewer than two epochs have no variance to split.
+    Jamanak one("jitter");
+    const auto later = Clock::now();
+    one.import_epoch({jam(later, "a", 0, 1000)}, later, jamanak_test::at(later, 1000));
+    CHECK(one.saturated_jams() == 0);
+    CHECK(one.jitter_contributors().empty());
+}
+
+} // namespace
+
+int main() {
+    test_sequential();
+    test_nested();
+    test_lanes();
+    test_untracked();
+    return jamanak_test::finish("jitter");
+}
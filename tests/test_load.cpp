@@ -0,0 +1,109 @@
+/// @file test_load.cpp
+/// @brief Open-loop load: LatencyHistogram quantiles and merging, and per-label collection in load().
+
+#include "jamanak_test.hpp"
+#include "jamanak_runner.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace jamanak;
+
+namespace {
+
+/// Values below 128 ns have exact buckets.
+void test_histogram_exact() {
+    LatencyHistogram h;
+    for (std::int64_t v = 0; v < 128; ++v) h.record(v);
+
+    CHECK(h.count() == 128);
+    CHECK_NEAR(h.mean(), 63.5, 1e-12);
+    CHECK_NEAR(h.max(), 127.0, 0.0);
+    CHECK_NEAR(h.quantile(0.0), 0.0, 0.0);
+    CHECK_NEAR(h.quantile(0.5), 63.0, 0.0);
+    CHECK_NEAR(h.quantile(1.0), 127.0, 0.0);
+    CHECK(h.count_above(99) == 28);
+    CHECK(h.count_above(-1) == 128);
+    CHECK(h.count_above(127) == 0);
+
+    // Negative values count as zero.
+    LatencyHistogram z;
+    z.record(-5);
+    CHECK(z.count() == 1 && z.max() == 0.0 && z.quantile(0.5) == 0.0);
+
+    CHECK(LatencyHistogram().quantile(0.99) == 0.0);
+}
+
+/// Above the exact range, quantiles are within one bucket: 1/64 relative.
+void test_histogram_quantiles() {
+    LatencyHistogram h, lo, hi;
+    for (std::int64_t v = 1; v <= 100000; ++v) {
+        h.record(v);
+        (v % 2 ? lo : hi).record(v);
+    }
+
+    CHECK(h.count() == 100000);
+    CHECK_NEAR(h.mean(), 50000.5, 1e-6);
+    CHECK_NEAR(h.max(), 100000.0, 0.0);
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        CHECK_NEAR(h.quantile(q), q * 100000.0, q * 100000.0 / 64.0);
+    }
+    CHECK(h.quantile(1.0) <= 100000.0);
+    CHECK_NEAR(static_cast<double>(h.count_above(90000)), 10000.0, 90000.0 / 64.0);
+
+    // Merging two halves gives the same histogram as recording everything into one.
+    lo.merge(hi);
+    CHECK(lo.count() == h.count());
+    CHECK(lo.mean() == h.mean());
+    CHECK(lo.max() == h.max());
+    for (double q : {0.01, 0.5, 0.99, 0.9999}) CHECK(lo.quantile(q) == h.quantile(q));
+
+    // The top of the int64 range has a bucket too.
+    LatencyHistogram big;
+    big.record(std::numeric_limits<std::int64_t>::max());
+    CHECK(big.quantile(0.5) <= big.max());
+    CHECK(big.quantile(0.5) > 0.9 * big.max());
+}
+
+/// Every call lands in the request histogram and the inner labels, while the buffered jams stay bounded.
+void test_load_labels() {
+    LoadOptions opts;
+    opts.rate = 40000.0;
+    opts.duration_s = 0.5;
+    opts.threads = 2;
+
+    std::vector<size_t> buffered(opts.threads, 0);
+    const auto result = load("request", [&](Jamanak& p, std::uint64_t k) {
+        p.start("parse");
+        p.stop();
+        p.start("reply");
+        p.stop();
+        auto& b = buffered[k % 2];
+        b = std::max(b, p.jam_count());
+    }, opts);
+
+    const std::uint64_t total = 20000;
+    CHECK(result.name == "request");
+    CHECK(result.calls == total);
+    CHECK(result.service.count() == total);
+    CHECK(result.labels.size() == 3);
+    CHECK(result.labels[0].context == "request" && result.labels[0].latency.count() == total);
+    CHECK(result.labels[1].context == "parse" && result.labels[1].latency.count() == total);
+    CHECK(result.labels[2].context == "reply" && result.labels[2].latency.count() == total);
+    CHECK(result.achieved_rate > 0.0);
+
+    // Each worker records 20000 jams but never buffers more than the fold limit plus one call.
+    for (size_t b : buffered) CHECK(b > 0 && b <= 4 * 4096 + 2);
+}
+
+} // namespace
+
+int main() {
+    test_histogram_exact();
+    test_histogram_quantiles();
+    test_load_labels();
+    return jamanak_test::finish("load");
+}
@@ -0,0 +1,136 @@
+/// @file test_packing.cpp
+/// @brief PackedJam limits: exact values at the limits, clamping and the saturation count.
+
+#include "jamanak_test.hpp"
+
+#include <chrono>
+#include <string>
+
+using namespace jamanak;
+using jamanak_test::at;
+
+namespace {
+
+/// Values up to each limit round-trip exactly and are not counted.
+void test_limits_fit() {
+    Jamanak p("packing");
+    const auto base = Clock::now();
+
+    p.record("dur", base, at(base, static_cast<std::int64_t>(PackedJam::max_dur)));
+    p.record("lane", base, at(base, 1000), PackedJam::max_thread);
+    p.record("zero", base, base);
+
+    const auto js = p.get_jams();
+    CHECK(p.saturated_jams() == 0);
+    CHECK(js.size() == 3);
+    CHECK(static_cast<std::uint64_t>(js[0].duration_ns) == PackedJam::max_dur);
+    CHECK(js[1].thread == PackedJam::max_thread);
+    CHECK(js[1].duration_ns == 1000);
+    CHECK(js[2].duration_ns == 0);
+}
+
+/// Every field past its limit is clamped and counted once per jam.
+void test_limits_clamp() {
+    Jamanak p("packing");
+    const auto base = Clock::now();
+
+    // Duration: 30 minutes exceeds 2^40 ns.
+    p.record("long", base, base + std::chrono::minutes(30));
+    CHECK(p.saturated_jams() == 1);
+    CHECK(static_cast<std::uint64_t>(p.get_jams()[0].duration_ns) == PackedJam::max_dur);
+
+    // One past the duration limit.
+    p.record("dur+1", base, at(base, static_cast<std::int64_t>(PackedJam::max_dur) + 1));
+    CHECK(p.saturated_jams() == 2);
+
+    // Lane one past its limit.
+    p.record("lane", base, at(base, 1000), PackedJam::max_thread + 1);
+    CHECK(p.saturated_jams() == 3);
+    CHECK(p.get_jams()[2].thread == PackedJam::max_thread);
+
+    // Start before the profiler's origin clamps to it.
+    p.record("early", base - std::chrono::hours(1), at(base, 500));
+    CHECK(p.saturated_jams() == 4);
+
+    // Start past 2^48 ns (about 78 hours).
+    p.record("late", base + std::chrono::hours(79), base + std::chrono::hours(79) + std::chrono::microseconds(1));
+    CHECK(p.saturated_jams() == 5);
+
+    // Negative duration.
+    p.record("backwards", at(base, 1000), base);
+    CHECK(p.saturated_jams() == 6);
+    CHECK(p.get_jams()[5].duration_ns == 0);
+
+    // Several fields out of range still count as one jam.
+    p.record("both", base - std::chrono::hours(1), base + std::chrono::minutes(30), PackedJam::max_thread + 1);
+    CHECK(p.saturated_jams() == 7);
+}
+
+/// The count survives epochs, shows up in the reports and resets with clean_epochs().
+void test_saturation_reporting() {
+    Jamanak p("packing");
+    const auto base = Clock::now();
+
+    p.import_epoch({jamanak_test::jam(base, "ok", 0, 1000),
+                    jamanak_test::jam(base, "long", 1000, 1000 + 1200ll * 1000 * 1000 * 1000)},
+                   base, base + std::chrono::minutes(21));
+    CHECK(p.saturated_jams() == 1);
+    CHECK(p.epoch_count() == 1);
+
+    CHECK(p.to_json().find("\"saturated_jams\": 1,") != std::string::npos);
+    CHECK(p.to_string_epochs().find("1 jam clamped to the packed limits") != std::string::npos);
+
+    p.clean_epochs();
+    CHECK(p.saturated_jams() == 0);
+    CHECK(p.to_json().find("\"saturated_jams\": 0,") != std::string::npos);
+}
+
+/// Epochs far past the start limit keep exact times once older epochs are dropped.
+void test_origin_rebase() {
+    Jamanak p("packing");
+    const auto base = Clock::now();
+    const std::int64_t hour = 3600ll * 1000 * 1000 * 1000;
+
+    // Each epoch: "a" for 1 µs, then a 500 ns gap, then "b" for 2 µs.
+    const auto epoch = [&](std::int64_t t) {
+        p.import_epoch({jamanak_test::jam(base, "a", t, t + 1000), jamanak_test::jam(base, "b", t + 1500, t + 3500)},
+                       at(base, t), at(base, t + 4000));
+    };
+
+    epoch(1000);
+    epoch(50 * hour);
+    CHECK(p.saturated_jams() == 0);
+
+    // The oldest epoch pins the origin, so each step of 50 h fits once it is dropped.
+    CHECK(p.drop_epochs(1) == 1);
+    epoch(100 * hour);
+    CHECK(p.drop_epochs(1) == 1);
+    epoch(150 * hour);
+    CHECK(p.saturated_jams() == 0);
+    CHECK(p.epoch_count() == 2);
+
+    CHECK_NEAR(p.epoch_wall_ns(), 4000.0, 1e-9);
+    CHECK_NEAR(p.epoch_untracked_ns(), 1000.0, 1e-9);
+    const auto stats = p.label_stats();
+    CHECK(stats.size() == 2);
+    CHECK_NEAR(stats[0].mean_ns, 1000.0, 1e-9);
+    CHECK_NEAR(stats[1].mean_ns, 2000.0, 1e-9);
+    CHECK_NEAR(stats[1].max_ns, 2000.0, 1e-9);
+
+    // Live jams after the rebase still come back at their own time points.
+    const auto t = base + std::chrono::hours(150) + std::chrono::microseconds(10);
+    p.record("c", t, t + std::chrono::microseconds(3));
+    const auto js = p.get_jams();
+    CHECK(p.saturated_jams() == 0);
+    CHECK(js.size() == 1 && js[0].t0 == t && js[0].duration_ns == 3000);
+}
+
+} // namespace
+
+int main() {
+    test_limits_fit();
+    test_limits_clamp();
+    test_saturation_reporting();
+    test_origin_rebase();
+    return jamanak_test::finish("packing");
+}
@@ -0,0 +1,86 @@
+/// @file test_periodic.cpp
+/// @brief Periodic loops: one epoch of wakeup and work jams, recording by interned label id.
+
+#include "jamanak_test.hpp"
+#include "jamanak_runner.hpp"
+
+#include <stdexcept>
+#include <string>
+
+using namespace jamanak;
+using jamanak_test::at;
+
+namespace {
+
+/// Jams recorded by id land under the same label as jams recorded by name.
+void test_record_by_id() {
+    Jamanak p("periodic");
+    const auto base = Clock::now();
+
+    const auto a = p.label_id("a");
+    CHECK(p.label_id("a") == a);
+    CHECK(p.label_id("b") != a);
+
+    p.record(a, base, at(base, 1000));
+    p.record("a", at(base, 1000), at(base, 3000));
+    p.end_epoch();
+    const auto stats = p.label_stats();
+    CHECK(stats.size() == 1);
+    CHECK(stats[0].context == "a" && stats[0].count == 2);
+    CHECK_NEAR(stats[0].epoch_ns, 3000.0, 1e-9);
+
+    bool threw = false;
+    try {
+        p.record(a + 7, base, at(base, 1000));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+/// Every cycle records a wakeup and a work jam into one epoch; unsaved jams are replaced.
+void test_cycles() {
+    Jamanak p("periodic");
+    const auto base = Clock::now();
+    p.record("unsaved", base, at(base, 1000));
+
+    PeriodicOptions opts;
+    opts.period_us = 200.0;
+    opts.cycles = 50;
+    size_t runs = 0;
+    const auto result = periodic(p, "tick", [&] { ++runs; }, opts);
+
+    CHECK(runs == 50);
+    CHECK(result.name == "tick" && result.cycles == 50);
+    CHECK_NEAR(result.period_ns, 200000.0, 1e-9);
+    CHECK_NEAR(result.deadline_ns, 200000.0, 1e-9);
+    CHECK(result.wakeup.count() == 50 && result.work.count() == 50);
+    CHECK(result.misses <= 50);
+
+    CHECK(p.epoch_count() == 1);
+    CHECK(p.jam_count() == 0);
+    const auto stats = p.label_stats();
+    CHECK(stats.size() == 2);
+    for (const auto& s : stats) {
+        CHECK(s.context == "tick wakeup" || s.context == "tick");
+        CHECK(s.count == 50);
+    }
+    CHECK(!to_string(result).empty());
+
+    bool threw = false;
+    try {
+        opts.period_us = 0.0;
+        periodic(p, "tick", [] {}, opts);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    test_record_by_id();
+    test_cycles();
+    return jamanak_test::finish("periodic");
+}
@@ -0,0 +1,75 @@
+/// @file test_scaling.cpp
+/// @brief Thread scaling: the Amdahl serial fraction fit and the per-label scaling points.
+
+#include "jamanak_test.hpp"
+#include "jamanak_runner.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace jamanak;
+
+namespace {
+
+/// Returns Amdahl speedups of serial fraction @p f at 1, 2, 4 and 8 threads.
+std::vector<ScalingPoint> amdahl(double f) {
+    std::vector<ScalingPoint> out;
+    for (size_t p : {1, 2, 4, 8}) {
+        ScalingPoint sp;
+        sp.threads = p;
+        sp.speedup = 1.0 / (f + (1.0 - f) / static_cast<double>(p));
+        sp.efficiency = sp.speedup / static_cast<double>(p);
+        out.push_back(sp);
+    }
+    return out;
+}
+
+/// The least-squares fit recovers f from exact Amdahl curves and stays within [0, 1].
+void test_serial_fraction() {
+    for (double f : {0.0, 0.05, 0.2, 0.5, 1.0}) CHECK_NEAR(serial_fraction(amdahl(f)), f, 1e-12);
+
+    // Superlinear speedups clamp to zero; a single thread count gives nothing to fit.
+    auto super = amdahl(0.0);
+    for (auto& p : super) p.speedup *= 1.5;
+    super.front().speedup = 1.0;
+    CHECK(serial_fraction(super) == 0.0);
+    CHECK(serial_fraction({amdahl(0.3).front()}) == 0.0);
+    CHECK(serial_fraction({}) == 0.0);
+
+    // Slowdowns clamp to one.
+    auto worse = amdahl(1.0);
+    for (auto& p : worse) if (p.threads > 1) p.speedup = 0.5;
+    CHECK(serial_fraction(worse) == 1.0);
+}
+
+/// A scaling run reports one point per thread count, with speedups relative to one thread.
+void test_scale_points() {
+    Jamanak p("scaling");
+    ScalingOptions opts;
+    opts.max_threads = 4;
+    opts.reps = 1;
+    const auto result = scale(p, "spin", [](Lane& lane, size_t, size_t) {
+        lane.start("work");
+        volatile unsigned sink = 0;
+        for (unsigned i = 0; i < 10000; ++i) sink = sink + i;
+        lane.stop();
+    }, opts);
+
+    CHECK(result.name == "spin");
+    CHECK(result.labels.size() == 1);
+    const auto& l = result.labels.front();
+    CHECK(l.context == "work");
+    CHECK(l.points.size() == 3);
+    CHECK(l.points[0].threads == 1 && l.points[1].threads == 2 && l.points[2].threads == 4);
+    CHECK_NEAR(l.points[0].speedup, 1.0, 1e-12);
+    CHECK(l.serial_fraction == serial_fraction(l.points));
+    CHECK(p.epoch_count() == 3);
+}
+
+} // namespace
+
+int main() {
+    test_serial_fraction();
+    test_scale_points();
+    return jamanak_test::finish("scaling");
+}
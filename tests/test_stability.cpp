@@ -0,0 +1,118 @@
+/// @file test_stability.cpp
+/// @brief PELT change points and least-squares drift on synthetic per-epoch series.
+
+#include "jamanak_test.hpp"
+
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace jamanak;
+using jamanak_test::jam;
+using jamanak_test::wiggle;
+
+namespace {
+
+/// Records @p n epochs: "s" takes level(i) ns, then "f" a flat 5 µs with the same noise.
+Jamanak series(size_t n, const std::function<double(size_t)>& level) {
+    Jamanak p("stability");
+    const auto base = Clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        const std::int64_t t = static_cast<std::int64_t>(i) * 1000000;
+        const auto s = static_cast<std::int64_t>(std::llround(level(i)));
+        const auto f = static_cast<std::int64_t>(5000.0 + 20.0 * wiggle(i + 3));
+        p.import_epoch({jam(base, "s", t, t + s), jam(base, "f", t + s, t + s + f)},
+                       jamanak_test::at(base, t), jamanak_test::at(base, t + s + f));
+    }
+    return p;
+}
+
+/// A single level shift is found at its epoch, with both segment means.
+void test_step() {
+    auto p = series(60, [](size_t i) { return (i < 30 ? 10000.0 : 12000.0) + 20.0 * wiggle(i); });
+    const auto st = p.stability();
+    CHECK(st.size() == 2);
+    CHECK(st[0].context == "s");
+
+    CHECK(st[0].changes.size() == 1);
+    if (!st[0].changes.empty()) {
+        CHECK(st[0].changes[0].epoch == 30);
+        CHECK_NEAR(st[0].changes[0].before_ns, 10000.0, 20.0);
+        CHECK_NEAR(st[0].changes[0].after_ns, 12000.0, 20.0);
+    }
+    CHECK(!st[0].drifting);
+
+    CHECK(st[1].changes.empty());
+    CHECK(!st[1].drifting);
+
+    // The report section lists the shift; without the option it is left out.
+    ReportOptions opts;
+    opts.stability = true;
+    const auto report = p.to_string_epochs(opts);
+    CHECK(report.find("change at epoch 30") != std::string::npos);
+    CHECK(p.to_string_epochs().find("change at epoch") == std::string::npos);
+}
+
+/// Two shifts, up then down, are both reported in epoch order.
+void test_two_steps() {
+    auto p = series(60, [](size_t i) { return (i >= 20 && i < 40 ? 13000.0 : 10000.0) + 20.0 * wiggle(i); });
+    const auto st = p.stability();
+    CHECK(st[0].changes.size() == 2);
+    if (st[0].changes.size() == 2) {
+        CHECK(st[0].changes[0].epoch == 20);
+        CHECK(st[0].changes[1].epoch == 40);
+        CHECK(st[0].changes[0].after_ns > st[0].changes[0].before_ns);
+        CHECK(st[0].changes[1].after_ns < st[0].changes[1].before_ns);
+    }
+    CHECK(!st[0].drifting);
+}
+
+/// A steady ramp is drift with the right slope, not a staircase of change points.
+void test_drift() {
+    auto p = series(60, [](size_t i) { return 10000.0 + 50.0 * static_cast<double>(i) + 5.0 * wiggle(i); });
+    const auto st = p.stability();
+    CHECK(st[0].changes.empty());
+    CHECK(st[0].drifting);
+    CHECK_NEAR(st[0].slope_ns, 50.0, 1.0);
+    CHECK(st[0].slope_t > 4.0);
+}
+
+/// Noise alone, and shifts below min_shift, report nothing.
+void test_quiet() {
+    auto flat = series(60, [](size_t i) { return 10000.0 + 20.0 * wiggle(i); });
+    for (const auto& s : flat.stability()) {
+        CHECK(s.changes.empty());
+        CHECK(!s.drifting);
+    }
+
+    // 2% shift: detectable, but below the default 5% threshold.
+    auto small = series(60, [](size_t i) { return (i < 30 ? 10000.0 : 10200.0) + 5.0 * wiggle(i); });
+    CHECK(small.stability()[0].changes.empty());
+    StabilityOptions loose;
+    loose.min_shift = 0.01;
+    const auto st = small.stability(loose);
+    CHECK(st[0].changes.size() == 1 && st[0].changes[0].epoch == 30);
+
+    // Too short for a segment on either side.
+    auto tiny = series(2, [](size_t i) { return i ? 20000.0 : 10000.0; });
+    const auto t = tiny.stability();
+    CHECK(t.size() == 2);
+    CHECK(t[0].changes.empty() && !t[0].drifting);
+
+    CHECK(Jamanak("empty").stability().empty());
+
+    ReportOptions opts;
+    opts.stability = true;
+    CHECK(flat.to_string_epochs(opts).find("all labels stable") != std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    test_step();
+    test_two_steps();
+    test_drift();
+    test_quiet();
+    return jamanak_test::finish("stability");
+}
@@ -0,0 +1,128 @@
+/// @file test_stages.cpp
+/// @brief Enum-indexed StageJamanak: bounds, running moments and the stage report.
+
+#include "jamanak_test.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace jamanak;
+using jamanak_test::at;
+
+namespace {
+
+enum class Stage { parse, solve, write, count };
+
+/// Chan's merge of two halves matches adding every value to one accumulator.
+void test_moments_merge() {
+    StageMoments all, lo, hi;
+    for (int i = 0; i < 10; ++i) {
+        const double x = 1000.0 + 37.0 * jamanak_test::wiggle(static_cast<size_t>(i));
+        all.add(x);
+        (i < 4 ? lo : hi).add(x);
+    }
+    StageMoments merged = lo;
+    merged.merge(hi);
+    merged.merge(StageMoments{});
+
+    CHECK(merged.count == all.count);
+    CHECK_NEAR(merged.mean, all.mean, 1e-9);
+    CHECK_NEAR(merged.m2, all.m2, 1e-6);
+    CHECK_NEAR(merged.sum, all.sum, 1e-9);
+    CHECK(merged.min == all.min);
+    CHECK(merged.max == all.max);
+
+    StageMoments empty;
+    empty.merge(all);
+    CHECK(empty.count == all.count);
+    CHECK(empty.m2 == all.m2);
+}
+
+/// Per-stage statistics over epochs of fixed stage times.
+void test_stage_stats() {
+    StageJamanak<Stage> p({"parse", "solve", "write"}, "stages");
+    const auto base = Clock::now();
+
+    // Epoch i: parse 1 µs, solve (i + 1) µs split over two calls; write never runs.
+    for (std::int64_t i = 0; i < 4; ++i) {
+        const std::int64_t t = i * 100000, s = (i + 1) * 1000;
+        p.begin_epoch();
+        CHECK(p.record(Stage::parse, at(base, t), at(base, t + 1000)) == 1000);
+        p.record(Stage::solve, at(base, t + 1000), at(base, t + 1000 + s / 2));
+        p.record(Stage::solve, at(base, t + 1000 + s / 2), at(base, t + 1000 + s));
+        p.end_epoch();
+    }
+
+    CHECK(p.epoch_count() == 4);
+    CHECK_NEAR(p.epoch_ns(Stage::parse), 1000.0, 1e-9);
+    CHECK_NEAR(p.epoch_ns(Stage::solve), 2500.0, 1e-9);
+    CHECK(p.epoch_ns(Stage::write) == 0.0);
+    CHECK(p.epoch_untracked_ns() >= 0.0);
+
+    const auto stats = p.label_stats();
+    CHECK(stats.size() == 2);
+    CHECK(stats[0].context == "parse" && stats[1].context == "solve");
+    CHECK(stats[0].count == 4);
+    CHECK_NEAR(stats[0].stddev_ns, 0.0, 1e-9);
+    CHECK(stats[1].count == 8);
+    CHECK_NEAR(stats[1].mean_ns, 1250.0, 1e-9);
+    CHECK_NEAR(stats[1].min_ns, 500.0, 1e-9);
+    CHECK_NEAR(stats[1].max_ns, 2000.0, 1e-9);
+    CHECK_NEAR(stats[1].stddev_ns, std::sqrt(2.5e6 / 7.0), 1e-6);
+    CHECK(stats[1].p50_ns == 0.0);
+
+    ReportOptions opts;
+    opts.columns = col_count | col_p95;
+    const auto report = p.to_string_epochs(opts);
+    CHECK(report.find("solve") != std::string::npos);
+    CHECK(report.find("write") == std::string::npos);
+    CHECK(report.find("p95") == std::string::npos);
+
+    p.clean_epochs();
+    CHECK(p.epoch_count() == 0);
+    CHECK(p.label_stats().empty());
+    CHECK(p.to_string_epochs().empty());
+}
+
+/// Stages outside the declared range are rejected instead of indexing past the arrays.
+void test_stage_bounds() {
+    StageJamanak<Stage> p({"parse", "solve", "write"}, "stages");
+    const auto bad = static_cast<Stage>(3);
+
+    bool threw = false;
+    try {
+        p.start(bad);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(!p.is_jamming());
+
+    // Also before any epoch, where there is nothing to read.
+    threw = false;
+    try {
+        p.epoch_ns(static_cast<Stage>(7));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    threw = false;
+    try {
+        const auto now = Clock::now();
+        p.record(bad, now, now);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    test_moments_merge();
+    test_stage_stats();
+    test_stage_bounds();
+    return jamanak_test::finish("stages");
+}
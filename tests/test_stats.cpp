@@ -0,0 +1,113 @@
+/// @file test_stats.cpp
+/// @brief Per-label moments, percentiles and rates, and the distribution columns of the epoch report.
+
+#include "jamanak_test.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace jamanak;
+using jamanak_test::jam;
+
+namespace {
+
+/// Returns the stats of @p context, or an empty entry if it is missing.
+LabelStats find(const std::vector<LabelStats>& stats, const std::string& context) {
+    for (const auto& s : stats) if (s.context == context) return s;
+    CHECK(!"label missing");
+    return {};
+}
+
+/// Moments, percentiles and rates against values worked out by hand.
+void test_label_stats() {
+    Jamanak p("stats");
+    const auto base = Clock::now();
+
+    // Epoch i: "a" takes (i + 1) µs with 10 items, then "b" runs twice for 200 and 400 ns.
+    for (std::int64_t i = 0; i < 5; ++i) {
+        const std::int64_t t = i * 100000, a = (i + 1) * 1000;
+        auto ja = jam(base, "a", t, t + a);
+        ja.items = 10;
+        p.import_epoch({ja, jam(base, "b", t + a, t + a + 200), jam(base, "b", t + a + 200, t + a + 600)},
+                       jamanak_test::at(base, t), jamanak_test::at(base, t + a + 600));
+    }
+
+    const auto stats = p.label_stats();
+    CHECK(stats.size() == 2);
+    CHECK(stats[0].context == "a");
+
+    const auto a = find(stats, "a");
+    CHECK(a.count == 5);
+    CHECK_NEAR(a.epoch_ns, 3000.0, 1e-9);
+    CHECK_NEAR(a.mean_ns, 3000.0, 1e-9);
+    CHECK_NEAR(a.min_ns, 1000.0, 1e-9);
+    CHECK_NEAR(a.max_ns, 5000.0, 1e-9);
+    CHECK_NEAR(a.stddev_ns, std::sqrt(2.5e6), 1e-6);
+    CHECK_NEAR(a.cv, std::sqrt(2.5e6) / 3000.0, 1e-12);
+    CHECK_NEAR(a.p50_ns, 3000.0, 1e-9);
+    CHECK_NEAR(a.p95_ns, 4800.0, 1e-9);
+    CHECK_NEAR(a.p99_ns, 4960.0, 1e-9);
+    CHECK_NEAR(a.calls_per_s, 5.0 / 15e-6, 1e-3);
+    CHECK_NEAR(a.items_per_s, 50.0 / 15e-6, 1e-3);
+    CHECK(a.bytes_per_s == 0.0);
+
+    const auto b = find(stats, "b");
+    CHECK(b.count == 10);
+    CHECK_NEAR(b.epoch_ns, 600.0, 1e-9);
+    CHECK_NEAR(b.mean_ns, 300.0, 1e-9);
+    CHECK_NEAR(b.stddev_ns, std::sqrt(1e5 / 9.0), 1e-9);
+    CHECK_NEAR(b.p50_ns, 300.0, 1e-9);
+
+    // The series are the per-epoch sums, in the same label order.
+    const auto series = p.label_series();
+    CHECK(series.size() == 2);
+    CHECK(series[0] == std::vector<double>({1000, 2000, 3000, 4000, 5000}));
+    CHECK(series[1] == std::vector<double>(5, 600.0));
+}
+
+/// The one-pass moments stay exact on a large offset, where a naive sum of squares cancels.
+void test_welford_offset() {
+    Jamanak p("stats");
+    const auto base = Clock::now();
+    const std::int64_t offset = 100000000000;              // 100 s, well inside the 2^40 ns limit.
+
+    for (std::int64_t k = 0; k < 100; ++k) {
+        const std::int64_t t = k * 2 * offset;
+        p.import_epoch({jam(base, "x", t, t + offset + k)}, jamanak_test::at(base, t),
+                       jamanak_test::at(base, t + offset + k));
+    }
+
+    const auto x = p.label_stats().front();
+    CHECK(x.count == 100);
+    CHECK_NEAR(x.mean_ns, static_cast<double>(offset) + 49.5, 1e-3);
+    CHECK_NEAR(x.stddev_ns, std::sqrt(100.0 * 101.0 / 12.0), 1e-3);
+}
+
+/// Only the requested columns appear in the report.
+void test_columns() {
+    Jamanak p("stats");
+    const auto base = Clock::now();
+    p.import_epoch({jam(base, "a", 0, 1000), jam(base, "a", 1000, 3000)}, base, jamanak_test::at(base, 3000));
+
+    ReportOptions plain;
+    const auto bare = p.to_string_epochs(plain);
+    CHECK(bare.find("p95") == std::string::npos);
+    CHECK(bare.find("stddev") == std::string::npos);
+
+    ReportOptions some;
+    some.columns = col_p95 | col_stddev;
+    const auto with = p.to_string_epochs(some);
+    CHECK(with.find("p95") != std::string::npos);
+    CHECK(with.find("stddev") != std::string::npos);
+    CHECK(with.find("p99") == std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    test_label_stats();
+    test_welford_offset();
+    test_columns();
+    return jamanak_test::finish("stats");
+}
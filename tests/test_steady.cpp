@@ -0,0 +1,59 @@
+/// @file test_steady.cpp
+/// @brief Warm-up detection on epoch totals and dropping of the warm-up epochs.
+
+#include "jamanak_test.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace jamanak;
+using jamanak_test::jam;
+
+namespace {
+
+/// Warm-up ends at the first window whose CV is below the threshold.
+void test_steady_epoch() {
+    Jamanak p("steady");
+    const auto base = Clock::now();
+    const std::vector<std::int64_t> totals{5000, 4000, 3000, 2000, 1000, 1000, 1010, 990, 1000, 1000, 1005, 995, 1000, 1000};
+
+    for (size_t i = 0; i < totals.size(); ++i) {
+        const std::int64_t t = static_cast<std::int64_t>(i) * 100000;
+        p.import_epoch({jam(base, "w", t, t + totals[i])}, jamanak_test::at(base, t),
+                       jamanak_test::at(base, t + totals[i]));
+    }
+
+    CHECK(p.epoch_totals().size() == totals.size());
+    CHECK(p.steady_epoch() == 4);
+    CHECK(p.drop_warmup() == 4);
+    CHECK(p.epoch_count() == totals.size() - 4);
+    CHECK(p.dropped_epochs() == 4);
+    CHECK_NEAR(p.label_stats().front().max_ns, 1010.0, 1e-9);
+
+    // Never steady: every epoch differs by far more than 5%.
+    Jamanak q("steady");
+    const auto later = Clock::now();
+    for (std::int64_t i = 0; i < 8; ++i) {
+        const std::int64_t t = i * 100000, d = 1000 << (i % 2 ? 1 : 0);
+        q.import_epoch({jam(later, "w", t, t + d)}, jamanak_test::at(later, t), jamanak_test::at(later, t + d));
+    }
+    CHECK(q.steady_epoch() == 8);
+    CHECK(q.drop_warmup() == 0);
+    CHECK(q.epoch_count() == 8);
+
+    // A looser threshold or a shorter window finds the steady state.
+    SteadyOptions loose;
+    loose.max_cv = 0.5;
+    CHECK(q.steady_epoch(loose) == 0);
+    SteadyOptions short_window;
+    short_window.window = 2;
+    CHECK(p.steady_epoch(short_window) == 0);
+    CHECK(Jamanak("empty").steady_epoch() == 0);
+}
+
+} // namespace
+
+int main() {
+    test_steady_epoch();
+    return jamanak_test::finish("steady");
+}
@@ -0,0 +1,63 @@
+/// @file test_sweep.cpp
+/// @brief Complexity sweeps: input sizes, class names and least-squares fits.
+
+#include "jamanak_test.hpp"
+#include "jamanak_runner.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace jamanak;
+
+namespace {
+
+/// Returns sweep points with time = f(n) for n = 2^10 .. 2^20.
+std::vector<SweepPoint> points(double (*f)(double)) {
+    std::vector<SweepPoint> out;
+    for (size_t n : pow2_sizes(size_t(1) << 10, size_t(1) << 20)) {
+        out.push_back({n, f(static_cast<double>(n)), 0.0});
+    }
+    return out;
+}
+
+/// Exact growth is recovered with its coefficient and zero residuals; the wrong class fits worse.
+void test_fit() {
+    CHECK(pow2_sizes(4, 64) == std::vector<size_t>({4, 8, 16, 32, 64}));
+    CHECK(std::string(complexity_name(Complexity::o_n_log_n)) == "O(n log n)");
+
+    const auto linear = points([](double n) { return 3.0 * n; });
+    const auto on = fit(linear, Complexity::o_n);
+    CHECK(on.complexity == Complexity::o_n);
+    CHECK_NEAR(on.coefficient, 3.0, 1e-9);
+    CHECK_NEAR(on.rms, 0.0, 1e-9);
+    CHECK(fit(linear, Complexity::o_n2).rms > 0.5);
+    CHECK(fit(linear, Complexity::o_n_log_n).rms > on.rms + 0.05);
+
+    const auto nlogn = points([](double n) { return 2.0 * n * std::log2(n); });
+    const auto onl = fit(nlogn, Complexity::o_n_log_n);
+    CHECK_NEAR(onl.coefficient, 2.0, 1e-9);
+    CHECK_NEAR(onl.rms, 0.0, 1e-9);
+    CHECK(fit(nlogn, Complexity::o_n).rms > onl.rms + 0.05);
+
+    const auto constant = points([](double) { return 250.0; });
+    CHECK_NEAR(fit(constant, Complexity::o_1).coefficient, 250.0, 1e-9);
+    CHECK_NEAR(fit(constant, Complexity::o_1).rms, 0.0, 1e-9);
+
+    // Relative residuals: a 10% error at the smallest size counts as much as at the largest.
+    auto skew = linear;
+    skew.front().mean_ns *= 1.1;
+    auto skew_big = linear;
+    skew_big.back().mean_ns *= 1.1;
+    CHECK_NEAR(fit(skew, Complexity::o_n).rms, fit(skew_big, Complexity::o_n).rms, 1e-12);
+
+    // Points without a time are skipped.
+    CHECK(fit({{1024, 0.0, 0.0}}, Complexity::o_n).coefficient == 0.0);
+}
+
+} // namespace
+
+int main() {
+    test_fit();
+    return jamanak_test::finish("sweep");
+}
@@ -0,0 +1,93 @@
+/// @file test_timeline.cpp
+/// @brief Gantt timeline rows and bucket shading for fixed jams.
+
+#include "jamanak_test.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace jamanak;
+using jamanak_test::at;
+using jamanak_test::jam;
+
+namespace {
+
+/// Removes ANSI escape sequences from @p s.
+std::string strip(const std::string& s) {
+    std::string out;
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '\x1b') {
+            while (i < s.size() && s[i] != 'm') ++i;
+            continue;
+        }
+        out += s[i];
+    }
+    return out;
+}
+
+/// Returns the bars of the row labelled @p label, or an empty string if it is missing.
+std::string row(const std::string& chart, const std::string& label) {
+    const std::string plain = strip(chart);
+    size_t line = 0;
+    while (line < plain.size()) {
+        size_t next = plain.find('\n', line);
+        if (next == std::string::npos) next = plain.size();
+        const std::string l = plain.substr(line, next - line);
+        if (l.rfind("|| " + label + "–", 0) == 0) {
+            const size_t from = l.find(": ") + 2, to = l.rfind(" ||");
+            return l.substr(from, to - from);
+        }
+        line = next + 1;
+    }
+    return "";
+}
+
+/// Rows are ordered by lane and show full, partial and empty buckets.
+void test_epoch_rows() {
+    Jamanak p("timeline");
+    const auto base = Clock::now();
+
+    // Eight 1 µs buckets over [0, 8 µs].
+    p.import_epoch({jam(base, "a", 0, 4000), jam(base, "c", 6500, 7000), jam(base, "b", 2000, 3000, 1)},
+                   base, at(base, 8000));
+
+    const auto chart = p.to_timeline_epoch(0, 8);
+    CHECK(chart.find("epoch 0") != std::string::npos);
+    CHECK(row(chart, "a") == "████    ");
+    CHECK(row(chart, "c") == "      ▒ ");
+    CHECK(row(chart, "b [1]") == "  █     ");
+
+    const std::string plain = strip(chart);
+    CHECK(plain.find("|| a") < plain.find("|| c"));
+    CHECK(plain.find("|| c") < plain.find("|| b [1]"));
+
+    bool threw = false;
+    try {
+        p.to_timeline_epoch(1, 8);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+/// The current epoch spans its first start to its last end.
+void test_current() {
+    Jamanak p("timeline");
+    const auto base = Clock::now();
+    CHECK(p.to_timeline(8).empty());
+
+    p.record("x", base, at(base, 2000));
+    p.record("y", at(base, 6000), at(base, 8000));
+    const auto chart = p.to_timeline(8);
+    CHECK(row(chart, "x") == "██      ");
+    CHECK(row(chart, "y") == "      ██");
+}
+
+} // namespace
+
+int main() {
+    test_epoch_rows();
+    test_current();
+    return jamanak_test::finish("timeline");
+}
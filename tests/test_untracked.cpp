@@ -0,0 +1,58 @@
+/// @file test_untracked.cpp
+/// @brief Untracked (gap) time: wall time not covered by any jam, with overlaps counted once.
+
+#include "jamanak_test.hpp"
+
+#include <string>
+
+using namespace jamanak;
+using jamanak_test::at;
+using jamanak_test::jam;
+
+namespace {
+
+/// Gaps in the current epoch; overlapping lanes and nested jams are covered once.
+void test_current_epoch() {
+    Jamanak p("untracked");
+    const auto base = Clock::now();
+
+    CHECK(p.wall_ns() == 0);
+    CHECK(p.untracked_ns() == 0);
+
+    p.record("a", base, at(base, 1000));
+    p.record("b", at(base, 1500), at(base, 2000));
+    p.record("c", at(base, 1800), at(base, 2500), 1);
+    p.record("inner", at(base, 200), at(base, 300));
+
+    // Wall: 0..2500; covered: 0..1000 and 1500..2500.
+    CHECK(p.wall_ns() == 2500);
+    CHECK(p.untracked_ns() == 500);
+}
+
+/// Completed epochs measure the gap against their own begin and end.
+void test_epochs() {
+    Jamanak p("untracked");
+    const auto base = Clock::now();
+
+    // Epoch 0: 100 ns before the first jam, a 500 ns hole and 100 ns after the last jam.
+    p.import_epoch({jam(base, "a", 100, 1100), jam(base, "b", 1600, 2100), jam(base, "c", 1900, 2600, 1)},
+                   base, at(base, 2700));
+    // Epoch 1: back to back, with no gap.
+    p.import_epoch({jam(base, "a", 10000, 11000), jam(base, "b", 11000, 11500)},
+                   at(base, 10000), at(base, 11500));
+
+    CHECK_NEAR(p.epoch_wall_ns(), (2700.0 + 1500.0) / 2.0, 1e-9);
+    CHECK_NEAR(p.epoch_untracked_ns(), (700.0 + 0.0) / 2.0, 1e-9);
+
+    const auto report = p.to_string_epochs();
+    CHECK(report.find("untracked") != std::string::npos);
+    CHECK(Jamanak("empty").epoch_untracked_ns() == 0.0);
+}
+
+} // namespace
+
+int main() {
+    test_current_epoch();
+    test_epochs();
+    return jamanak_test::finish("untracked");
+}